@@ -31,6 +31,7 @@ struct CameraUniforms {
   alignas(4) int imageWidth;
   alignas(4) int imageHeight;
   alignas(4) int shDegree;
+  alignas(16) glm::mat4 prevViewProj;
   // Note: padding may be added automatically to align to 16 bytes
 };
 class Camera {
@@ -9,17 +9,89 @@
 #include "VulkanContext.h"
 #include "glm/glm.hpp"
 #include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <limits>
 #include <map>
-#define NOT_SHARED_MEM_RENDERING
+#include <sstream>
 #include "GraphicsPipeline.h"
 #include "RenderSettings.h"
+#include "SplatRasterPipeline.h"
 
 const uint32_t WORKGROUP_SIZE = 256;
 const uint32_t RADIX_SORT_BINS = 256;
 const uint32_t blocks_per_workgroup = 32;
 constexpr int frames_in_flight = 2;
 
+// Slots of the GPU counters buffer (see Shaders/counters.glsl), mirrored into
+// the numRendered staging buffer at the end of every preprocess pass
+const uint32_t COUNTER_NUM_RENDERED = 0;
+const uint32_t COUNTER_SORT_INVERSIONS = 1;
+const uint32_t COUNTER_VISIBLE = 2;
+const uint32_t COUNTER_SPLIT_CHUNKS = 3;
+const uint32_t COUNTER_PREFIX_ARGS = 4; // VkDispatchIndirectCommand
+const uint32_t COUNTER_OCCLUDED = 7;
+const uint32_t COUNTER_SPLIT_ARGS = 8;  // VkDispatchIndirectCommand
+const uint32_t COUNTER_SH_REDUCED = 11;
+const uint32_t COUNTER_TILE_ARGS = 12;  // VkDispatchIndirectCommand
+const uint32_t COUNTER_SH_LOD_ERROR = 15;
+const uint32_t COUNTER_SH_EVALS = 16;
+const uint32_t COUNTER_SH_FETCHES = 17;
+const uint32_t COUNTER_CLUSTER_ARGS = 18; // VkDispatchIndirectCommand
+const uint32_t COUNTER_BUDGET_BIN = 21;
+const uint32_t COUNTER_BUDGET_DROPPED = 22;
+const uint32_t COUNTER_ROW_SPANS = 23;
+const uint32_t COUNTER_SPLATS_KEPT = 24;
+const uint32_t NUM_COUNTERS = 25;
+
+// Importance histogram bins of the splat budget, see splat_budget.comp
+const uint32_t SPLAT_BUDGET_BINS = 256;
+
+// Frames each rasterizer kernel is timed for before Auto settles on one
+const uint32_t RASTER_BENCH_FRAMES = 32;
+
+// Setting checks: frames each value renders before its timings count, then
+// the frames they are averaged over. The last one is captured
+const uint32_t CHECK_WARMUP_FRAMES = 4;
+const uint32_t CHECK_FRAMES = 16;
+
+// RGBA8 slices of the capture buffer, one per render path or checked value
+const uint32_t NUM_CAPTURE_SLOTS = 3;
+static_assert(NUM_RENDER_MODES <= NUM_CAPTURE_SLOTS &&
+                  NUM_COV_PRECISIONS <= NUM_CAPTURE_SLOTS,
+              "One capture slot per render path and per checked value");
+
+// Timestamp queries per swapchain image: the rasterizer pair, the tile ID
+// pair, then one pair per render path
+const uint32_t TIMESTAMPS_PER_IMAGE = 4 + 2 * NUM_RENDER_MODES;
+
+// Smallest tile edge of the TileSize presets; the ranges buffer is sized for
+// it so switching tile size never reallocates
+const uint32_t MIN_TILE_SIZE = 8;
+const uint32_t MAX_TILE_PIXELS = 32 * 32;
+
+// Chunks of split tiles the partials buffer holds per frame at the largest
+// tile size. Smaller tiles fit proportionally more, up to MAX_SPLIT_WORK
+const uint32_t MAX_SPLIT_CHUNKS = 2048;
+const uint32_t MAX_SPLIT_WORK =
+    MAX_SPLIT_CHUNKS * MAX_TILE_PIXELS / (MIN_TILE_SIZE * MIN_TILE_SIZE);
+
+// Specialization constants shared by every tile-dependent shader
+struct TileSpecialization {
+  uint32_t width;      // constant_id 0
+  uint32_t height;     // constant_id 1
+  uint32_t quadWidth;  // constant_id 2, render_quad workgroup
+  uint32_t quadHeight; // constant_id 3
+};
+
+// Specialization data passed to every compute pipeline
+struct SpecializationData {
+  TileSpecialization tile; // constant_id 0-3
+  uint32_t subgroupSize;   // constant_id 4, SUBGROUP_SIZE
+};
+
 struct DescriptorBinding {
   uint32_t binding;
   VkDescriptorType type;
@@ -36,6 +108,7 @@ enum class PipelineType {
   PREPROCESS,
   PREFIXSUM,
   ASSIGN_TILE_IDS,
+  ASSIGN_TILE_IDS_GAUSSIAN, // ASSIGN_TILE_IDS layout, thread per Gaussian
   NEAREST,
   RADIX_HISTOGRAM_0,
   RADIX_HISTOGRAM_1,
@@ -43,19 +116,39 @@ enum class PipelineType {
   RADIX_SCATTER_1,
   TILE_BOUNDARIES,
   RENDER,
-  UPSAMPLING
+  UPSAMPLING,
+  DEPTH_KEYS,
+  SORT_REPAIR,
+  RENDER_SHARED, // shares the RENDER layout and descriptor sets
+  RENDER_QUAD,   // same, 2x2 pixels per thread
+  PACK_SPLATS,
+  TILE_SPLIT,
+  RENDER_CHUNK, // RENDER layout, sub-ranges of split tiles
+  RENDER_MERGE, // RENDER layout, composites the chunks
+  RENDER_GATHER, // RENDER layout, per-pixel without the packed records
+  WBOIT_RESOLVE,
+  COV3D,
+  CLUSTER_CULL,
+  SPLAT_BUDGET
 };
 
 class ComputePipeline {
 public:
   ComputePipeline(VulkanContext &vkContext, ImguiUI &imguiHandler,
-                  GraphicsPipeline &graphicsPipeline)
+                  GraphicsPipeline &graphicsPipeline,
+                  SplatRasterPipeline &splatRasterPipeline)
       : _vkContext(vkContext), _imGuiHandler(imguiHandler),
-        _graphicsPipeline(graphicsPipeline){};
+        _graphicsPipeline(graphicsPipeline),
+        _splatRasterPipeline(splatRasterPipeline){};
   ~ComputePipeline() { CleanUp(); }
 
   void Initialize(GaussianBuffers gaussianBuffer);
-  void RenderFrame(Camera &cam);
+  // cacheFrame keeps a copy of the scene, without axis and UI, for
+  // PresentCachedFrame
+  void RenderFrame(Camera &cam, bool cacheFrame = false);
+  // Idle frame: re-presents the cached scene under a fresh axis and UI pass
+  void PresentCachedFrame(Camera &cam);
+  bool HasCachedFrame() const { return _frameCache.valid; }
   void CleanUp();
   void setNumGaussians(int gauss) {
     _numGaussians = gauss;
@@ -70,6 +163,7 @@ private:
   VulkanContext &_vkContext;
   ImguiUI &_imGuiHandler;
   GraphicsPipeline &_graphicsPipeline;
+  SplatRasterPipeline &_splatRasterPipeline;
   std::vector<VkCommandBuffer> _commandBuffers;
   std::vector<VkCommandBuffer> _renderCommandBuffers;
   std::vector<VkFence> _preprocessFences;
@@ -89,11 +183,84 @@ private:
   void CreateSynchronization();
   void CreateDescriptorSetLayout(const PipelineType pType);
   void CreateDescriptorPool();
+  // subgroupInvocations: workgroup size of kernels that depend on
+  // SUBGROUP_SIZE, 0 for the rest
   void CreateComputePipeline(std::string shaderName, const PipelineType pType,
-                             int numPushConstants = 0);
+                             int numPushConstants = 0,
+                             uint32_t subgroupInvocations = 0);
+  VkPipeline BuildComputePipeline(const std::string &shaderName,
+                                  VkPipelineLayout layout,
+                                  uint32_t subgroupInvocations = 0);
+  void CreateTimestampQueries();
+  void ReadRenderTimestamps(uint32_t imageIndex);
+  Rasterizer SelectRasterizer();
   void SetupDescriptorSet(const PipelineType pType);
   void RecordCommandPreprocess(uint32_t imageIndex);
-  void RecordCommandRender(uint32_t imageIndex, int numRendered, Camera &cam);
+  // compare: render the other paths first and capture every output.
+  // captureSlot: capture the displayed output there, -1 for none
+  void RecordCommandRender(uint32_t imageIndex, int numRendered, Camera &cam,
+                           bool fullSort, RenderMode mode, bool compare,
+                           bool cacheFrame, int captureSlot = -1);
+  // Axis and ImGui over the scene in GENERAL layout, then to present
+  void RecordOverlays(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                      Camera &cam);
+  void RecordFrameCache(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+  void CreateFrameCache();
+  void PresentImage(uint32_t imageIndex);
+  void RecordRenderPath(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                        int numRendered, bool fullSort, RenderMode mode);
+  void RecordSortedPath(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                        int numRendered, bool fullSort);
+  void RecordSortFreePath(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+  void RecordSortedQuadPath(VkCommandBuffer commandBuffer,
+                            uint32_t imageIndex);
+  void RecordSplatResolve(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                          bool sortedQuads);
+  void RecordOutputCapture(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                           uint32_t slot);
+  // PSNR of capture slot against reference, maxError gets the largest 8-bit
+  // channel difference
+  float ComputeCapturePsnr(uint32_t slot, uint32_t reference,
+                           int *maxError = nullptr);
+  // Setting check, see RenderSettings::settingCheck. Update starts a
+  // requested check and writes the value under test into g_renderSettings
+  void UpdateSettingCheck(Camera &cam);
+  void AdvanceSettingCheck(uint32_t imageIndex, uint32_t numRendered,
+                           Camera &cam);
+  void FinishSettingCheck(const std::string &abortReason);
+  static int GetCheckedSetting(SettingCheck kind);
+  static void SetCheckedSetting(SettingCheck kind, int value);
+  void RecordRadixSort(VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                       uint32_t numElements, uint32_t firstShift,
+                       uint32_t numPasses);
+  void RecordSortOrderUpdate(VkCommandBuffer commandBuffer,
+                             uint32_t imageIndex);
+  void InsertMemoryBarrier(
+      VkCommandBuffer commandBuffer,
+      VkAccessFlags src = VK_ACCESS_SHADER_WRITE_BIT,
+      VkAccessFlags dst = VK_ACCESS_SHADER_READ_BIT,
+      VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+  uint32_t GetTileSortPasses();
+  VkExtent2D GetTileGrid();
+  // Swapchain extent over _windowResize; the render extent scales it down
+  VkExtent2D GetNativeExtent();
+  void SetRenderScale(float scale);
+  bool UpsampleNeeded();
+  // Switches the RENDER and WBOIT_RESOLVE output between the swapchain and
+  // the render target the upsampling pass reads
+  void ApplyUpsampling();
+  void UpdateRenderScale();
+  static TileSpecialization TileSpecFor(TileSize size);
+  bool TileSizeSupported(const TileSpecialization &spec);
+  void ApplyTileSize();
+  // (Re)creates the cov3D buffer when the selected CovPrecision changes
+  void ApplyCovPrecision();
+  void RecordCov3DBuild(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+  void RecordClusterCull(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+  void RecordSplatBudget(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+  void ReadPreprocessTimestamps(uint32_t imageIndex);
+  void UpdateOcclusionState(Camera &cam);
   VkShaderModule CreateShaderModule(const std::vector<char> &code);
 
   void TransitionImage(VkCommandBuffer commandBuffer, VkImageLayout in,
@@ -158,7 +325,61 @@ private:
         {12, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "tilesTouched"},
         {13, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
-         "boundingBox"}}},
+         "boundingBox"},
+        {14, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "visibleList"},
+        {15, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"},
+        {16, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tileDepth"},
+        {17, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "cov3D"},
+        {18, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "colorCache"},
+        {19, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "shBand1"},
+        {20, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "shBand2"},
+        {21, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "shBand3"},
+        {22, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "visibleClusters"},
+        {23, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "rowSpans"},
+        {24, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "rowTables"}}},
+
+      {PipelineType::COV3D,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "scales"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "rotations"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "cov3D"}}},
+
+      {PipelineType::CLUSTER_CULL,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "clusterBounds"},
+        {1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "camUniform"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "visibleClusters"},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"}}},
+
+      {PipelineType::SPLAT_BUDGET,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "visibleList"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "radii"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "conicOpacity"},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tilesTouched"},
+        {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"},
+        {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "budgetHistogram"}}},
 
       {PipelineType::NEAREST,
        {{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1,
@@ -180,7 +401,9 @@ private:
        {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "tilesTouched"},
         {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
-         "tilesTouchedPrefixSum"}}},
+         "tilesTouchedPrefixSum"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"}}},
 
       {PipelineType::ASSIGN_TILE_IDS,
        {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
@@ -194,8 +417,44 @@ private:
         {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "keys"},
         {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "values"},
+        {6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "visibleList"},
+        {7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "pointsXY"},
+        {8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "conicOpacity"},
+        {9, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"},
+        {10, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "rowSpans"},
+        {11, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "rowTables"}}},
+
+      {PipelineType::DEPTH_KEYS,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "depths"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "radii"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "keys"},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "values"}}},
 
+      {PipelineType::SORT_REPAIR,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "sortOrder"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "depths"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "radii"},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tilesTouched"},
+        {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tilesTouchedPrefixSum"},
+        {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"}}},
+
       {PipelineType::RADIX_HISTOGRAM_0,
        {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "keys"},
@@ -236,21 +495,74 @@ private:
        {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "keys"},
         {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
-         "ranges"}}},
+         "ranges"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "activeTiles"},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "counters"}}},
+
+      {PipelineType::PACK_SPLATS,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "values"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "pointsXY"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "conicOpacity"},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "rgb"},
+        {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "records"},
+        {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "keys"}}},
 
       {PipelineType::RENDER,
        {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "ranges"},
         {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "records"},
+        {5, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "outputImage"},
+        {6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tileSplit"},
+        {7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tileWork"},
+        {8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "partials"},
+        {9, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "activeTiles"},
+        {10, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "keys"},
+        {11, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tileDepth"},
+        // Unpacked splat data, read by RENDER_GATHER only
+        {12, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "values"},
-        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+        {13, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "pointsXY"},
+        {14, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "conicOpacity"},
+        {15, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
          "rgb"},
+        {16, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "partialDepths"}}},
+
+      {PipelineType::WBOIT_RESOLVE,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "outputImage"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "wboitAccum"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "wboitReveal"}}},
+
+      {PipelineType::TILE_SPLIT,
+       {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "ranges"},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tileSplit"},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
+         "tileWork"},
         {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
-         "conicOpacity"},
-        {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1,
-         "pointsXY"},
-        {5, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1,
-         "outputImage"}}},
+         "counters"}}},
 
       {PipelineType::UPSAMPLING,
        {{0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -267,6 +579,118 @@ private:
 
   VkBuffer _resultBufferPrefix;
 
+  // Temporal sort: sortOrder is rebuilt with a full depth sort whenever the
+  // repair passes leave too many inversions behind
+  bool _temporalSort = false;
+  bool _rebuildSortOrder = true;
+
+  // GPU timing of the rasterizer dispatch, the tile ID pass and the whole
+  // render path, TIMESTAMPS_PER_IMAGE queries per swapchain image
+  VkQueryPool _timestampPool = VK_NULL_HANDLE;
+  float _timestampPeriod = 0.0f; // ns per tick, 0 when unsupported
+  std::vector<bool> _timestampPending;
+  std::vector<Rasterizer> _timestampKernel;
+  std::vector<uint32_t> _pathTimestampMask; // bit per RenderMode written
+  std::vector<RenderMode> _displayedMode;   // path shown, see _renderMs
+  // Four preprocess queries per image follow the render ones: the preprocess
+  // dispatch, then the whole preprocess submission
+  uint32_t _preprocessQueryBase = 0;
+
+  // Covariance storage the cov3D buffer holds; built on the next preprocess
+  // while _cov3DDirty is set
+  CovPrecision _covPrecision = CovPrecision::None;
+  bool _cov3DDirty = false;
+
+  // The color cache starts out zeroed, which marks every entry invalid
+  bool _clearColorCache = true;
+
+  // This preprocess also measures the SH LOD error against the full degree
+  bool _shLodReport = false;
+
+  // Preprocess runs over the clusters that pass cluster_cull.comp, see
+  // GaussianBase::BuildClusters. Latched per preprocess
+  uint32_t _numClusters = 0;
+  bool _clusterCull = false;
+
+  // Outputs of the last A/B comparison or setting check, RGBA8 each
+  VkBuffer _captureBuffer = VK_NULL_HANDLE;
+  VkExtent2D _captureExtent = {};
+
+  // Setting check in progress: the value under test, its frame and the sums
+  // of every value's measurements over CHECK_FRAMES frames
+  struct SettingCheckState {
+    SettingCheck kind = SettingCheck::None;
+    int value = 0;
+    uint32_t frame = 0;
+    int restore = 0; // setting before the check
+    glm::vec3 camPos = glm::vec3(0.0f);
+    glm::vec3 camFront = glm::vec3(0.0f);
+    double numRendered[NUM_CAPTURE_SLOTS] = {};
+    double preprocessMs[NUM_CAPTURE_SLOTS] = {};
+    double frontEndMs[NUM_CAPTURE_SLOTS] = {};
+    double renderMs[NUM_CAPTURE_SLOTS] = {};
+    double tileIdMs[NUM_CAPTURE_SLOTS] = {};
+    double rasterMs[NUM_CAPTURE_SLOTS] = {};
+  } _check;
+
+  // Scene image of the last cached frame, swapchain sized and formatted.
+  // Kept in TRANSFER_SRC_OPTIMAL once written
+  struct FrameCache {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    bool valid = false;
+  } _frameCache;
+
+  // Dynamic resolution: the frame is rasterized into the top left
+  // _renderExtent of the render target and upsampled to the swapchain. The
+  // resolution dependent buffers keep their native size, so a scale change
+  // only moves the sub-rectangle
+  VkExtent2D _renderExtent = {};
+  bool _upsample = false;
+  float _preprocessMs = 0.0f; // GPU time of the last preprocess dispatch
+  float _frontEndMs = 0.0f;   // of its whole submission, prefix sum included
+  float _renderMs = 0.0f;     // of the last displayed render path
+  float _scaleError[2] = {};  // frame time error of the last two updates
+
+  // Auto rasterizer selection
+  const std::map<Rasterizer, PipelineType> _rasterKernels = {
+      {Rasterizer::PerPixel, PipelineType::RENDER},
+      {Rasterizer::SharedMemory, PipelineType::RENDER_SHARED},
+      {Rasterizer::Quad, PipelineType::RENDER_QUAD}};
+  std::map<Rasterizer, double> _rasterTimeMs;
+  std::map<Rasterizer, uint32_t> _rasterSamples;
+  Rasterizer _autoRasterizer = Rasterizer::PerPixel;
+  bool _rasterBenchDone = false;
+  uint32_t _rasterBenchFrame = 0;
+  int _lastRasterizer = -1;
+
+  // Tile size the tile-dependent pipelines are currently specialized for
+  TileSpecialization _tileSpec = {16, 16, 8, 8};
+  int _activeTileSize = int(TileSize::Tile16x16);
+  uint32_t _subgroupSize = 32;
+
+  // Camera and tiling of the frame whose saturation depths are in tileDepth
+  struct OcclusionHistory {
+    bool valid = false;
+    glm::vec3 camPos = glm::vec3(0.0f);
+    float fov = 0.0f;
+    TileSpecialization tileSpec = {};
+    VkExtent2D tileGrid = {};
+  } _occlusionHistory;
+  bool _occlusionActive = false;
+  float _occlusionMargin = 0.0f;
+  const std::map<PipelineType, std::string> _tileShaders = {
+      {PipelineType::PREPROCESS, "preprocess.spv"},
+      {PipelineType::ASSIGN_TILE_IDS, "idkeys.spv"},
+      {PipelineType::ASSIGN_TILE_IDS_GAUSSIAN, "idkeys_gaussian.spv"},
+      {PipelineType::PACK_SPLATS, "pack_splats.spv"},
+      {PipelineType::RENDER, "render.spv"},
+      {PipelineType::RENDER_SHARED, "render_shared.spv"},
+      {PipelineType::RENDER_QUAD, "render_quad.spv"},
+      {PipelineType::RENDER_CHUNK, "render_chunk.spv"},
+      {PipelineType::RENDER_MERGE, "render_merge.spv"},
+      {PipelineType::RENDER_GATHER, "render_gather.spv"}};
+
   struct RenderTarget {
     VkImage image;
     VkDeviceMemory memory;
@@ -285,6 +709,10 @@ private:
     return *static_cast<uint32_t *>(_gaussianBuffers.numRendered.mem);
   }
 
+  inline uint32_t ReadCounter(uint32_t slot) {
+    return static_cast<uint32_t *>(_gaussianBuffers.numRendered.mem)[slot];
+  }
+
   inline bool IsRadixPipeline(PipelineType pType) {
     return pType == PipelineType::RADIX_HISTOGRAM_0 ||
            pType == PipelineType::RADIX_HISTOGRAM_1 ||
@@ -15,7 +15,16 @@ public:
   const void *GetScalesData() const { return _scales.data(); }
   const void *GetRotationsData() const { return _rotations.data(); }
   const void *GetOpacitiesData() const { return _opacities.data(); }
-  const void *GetSHData() const { return _shCoefficients.data(); }
+  // SH after BuildSHPlanes, one plane per band
+  const void *GetSHPlaneData(int band) const {
+    return _shPlanes[band].data();
+  }
+  size_t GetSHPlaneBytes(int band) const {
+    return _shPlanes[band].size() * sizeof(uint32_t);
+  }
+  // Two vec4 per cluster: min and max corner
+  const void *GetClusterBoundsData() const { return _clusterBounds.data(); }
+  size_t GetClusterCount() const { return _clusterBounds.size() / 2; }
 
   size_t GetCount() const { return _numGaussians; }
   int GetSHDegree() const { return _shDegree; }
@@ -23,12 +32,26 @@ public:
     return (_shDegree + 1) * (_shDegree + 1);
   }
 
+  // Reorders the Gaussians along a Morton curve so that every clusterSize
+  // consecutive ones form a compact cluster, and bounds each cluster by the
+  // 3 sigma extents of its Gaussians. Runs before BuildSHPlanes
+  void BuildClusters(uint32_t clusterSize);
+
+  // Splits the interleaved SH into per-band planes. Every Gaussian keeps the
+  // smallest degree whose dropped bands change no color channel by more than
+  // tolerance in any view direction, and has an entry in the planes up to it:
+  // DC plane: rgb, rank1 << 2 | degree. Plane l: at the Gaussian's rank among
+  // those of degree >= l, the band-1 entry holding the band-2 and -3 ranks
+  void BuildSHPlanes(float tolerance);
+
   ~GaussianBase(){};
 
   // Data vectors
   std::vector<glm::vec4> _xyz;
   std::vector<glm::vec3> _normals;
-  std::vector<float> _shCoefficients;
+  std::vector<float> _shCoefficients; // interleaved, freed by BuildSHPlanes
+  std::vector<uint32_t> _shPlanes[4];
+  std::vector<glm::vec4> _clusterBounds;
   std::vector<float> _opacities;
   std::vector<glm::vec4> _scales;
   std::vector<glm::vec4> _rotations;
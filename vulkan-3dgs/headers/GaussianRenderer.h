@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 
 #include "BufferManager.h"
 #include "Camera.h"
@@ -13,6 +15,11 @@
 #include "Imgui3DGS.h"
 #include "RenderSettings.h"
 #include "Sequence.h"
+#include "SplatRasterPipeline.h"
+
+// Frames still rendered after the last change before the image is reused,
+// so the temporal sort, occlusion history and resolution controller settle
+constexpr int IDLE_SETTLE_FRAMES = 8;
 
 class GaussianRenderer {
  public:
@@ -22,7 +29,9 @@ class GaussianRenderer {
         _bufferManager(),
         _imguiHandler(vulkanContext, seqRecorder),
         _graphcsPipeline(_vulkanContext),
-        _computePipeline(vulkanContext, _imguiHandler, _graphcsPipeline),
+        _splatRasterPipeline(_vulkanContext),
+        _computePipeline(vulkanContext, _imguiHandler, _graphcsPipeline,
+                         _splatRasterPipeline),
         _shDegree(shDegree) {
     std::cout << "GaussianRenderer created" << std::endl;
   };
@@ -54,12 +63,15 @@ class GaussianRenderer {
   ComputePipeline _computePipeline;
   ImguiUI _imguiHandler;
   GraphicsPipeline _graphcsPipeline;
+  SplatRasterPipeline _splatRasterPipeline;
 
   void CreateGaussianBuffers();
   void CreatePipelineStorageBuffers();
   template <typename T>
   void CreateAndUploadBuffer(VkBuffer &buffer, const void *data,
                              std::string type, int offset = 1);
+  void UploadBuffer(VkBuffer &buffer, const void *data, std::string type,
+                    VkDeviceSize bufferSize);
 
   template <typename T>
   void CreateWriteBuffers(VkBuffer &buffer, std::string type, int offset = 1,
@@ -67,11 +79,20 @@ class GaussianRenderer {
   void CreateUniformBuffer();
   void CreateCopyStagingBuffer();
   void CreateRangesBuffer();
+  void CreateSplitBuffers();
+  void CreateCountersBuffer();
   GaussianBuffers _buffers;
   std::shared_ptr<Camera> _camera;
   int _shDegree;
   uint32_t _nGauss;
   void *_cameraUniformMapped = nullptr;
+  glm::mat4 _prevViewProj = glm::mat4(1.0f);
+
+  // Idle frame detection, updated with the camera uniforms
+  bool _sceneChanged = true;
+  int _settleFrames = IDLE_SETTLE_FRAMES;
+  CameraUniforms _lastUniforms = {};
+  decltype(g_renderSettings.ImageInputs()) _lastInputs;
 };
 
 template <typename T>
@@ -79,33 +100,8 @@ inline void GaussianRenderer::CreateAndUploadBuffer(VkBuffer &buffer,
                                                     const void *data,
                                                     std::string type,
                                                     int offset) {
-  VkDevice device = _vulkanContext.GetLogicalDevice();
-  VkPhysicalDevice physicalDevice = _vulkanContext.GetPhysicalDevice();
-
-  VkDeviceSize bufferSize = _gaussianData->GetCount() * sizeof(T) * offset;
-  std::cout << " Creating " << type << " buffer : " << bufferSize << " bytes "
-            << std::endl;
-  buffer =
-      _bufferManager.CreateStorageBuffer(device, physicalDevice, bufferSize);
-
-  VkBuffer stagingBuffer = _bufferManager.CreateBuffer(
-      device, physicalDevice, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-  void *mappedMem;
-  VkDeviceMemory deviceMem = _bufferManager.GetBufferMemory(stagingBuffer);
-  vkMapMemory(device, deviceMem, 0, bufferSize, 0, &mappedMem);
-  memcpy(mappedMem, data, static_cast<size_t>(bufferSize));
-  vkUnmapMemory(device, deviceMem);
-
-  _bufferManager.copyBuffer(device, bufferSize, stagingBuffer, buffer,
-                            _vulkanContext.GetCommandPool(),
-                            _vulkanContext.GetGraphicsQueue());
-
-  _bufferManager.DestroyBuffer(device, stagingBuffer);
-
-  std::cout << " buffer created!" << std::endl;
+  UploadBuffer(buffer, data, type,
+               _gaussianData->GetCount() * sizeof(T) * offset);
 }
 
 template <typename T>
@@ -118,7 +114,8 @@ inline void GaussianRenderer::CreateWriteBuffers(VkBuffer &buffer,
   VkPhysicalDevice physicalDevice = _vulkanContext.GetPhysicalDevice();
   VkDevice device = _vulkanContext.GetLogicalDevice();
   VkBufferUsageFlags usage = (dst) ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT
                                    : VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
   buffer =
       _bufferManager.CreateBuffer(device, physicalDevice, bufferSize, usage,
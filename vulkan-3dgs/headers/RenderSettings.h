@@ -1,12 +1,38 @@
 #pragma once
 #include "glm/glm.hpp"
 #include "string"
+#include <tuple>
+
+enum class Rasterizer { Auto = 0, PerPixel, SharedMemory, Quad };
+enum class TileSize { Tile8x8 = 0, Tile16x16, Tile32x16, Tile32x32 };
+// Sorted: tile-sorted compute rasterizers. SortFree: weighted blended OIT.
+// SortedQuads: globally depth-sorted quads through the hardware rasterizer
+enum class RenderMode { Sorted = 0, SortFree, SortedQuads };
+const int NUM_RENDER_MODES = 3;
+// Source of the 3D covariance in preprocess: rebuilt from scale and rotation
+// every frame, or precomputed once and stored in fp32 or fp16
+enum class CovPrecision { None = 0, Fp32, Fp16 };
+const int NUM_COV_PRECISIONS = 3;
+// Settings the A/B check measures, each over its values 0, 1, ...
+enum class SettingCheck {
+  None = 0,
+  ExactTiles,
+  OpacityRadius,
+  TileIdThreads,
+  PackedSplats,
+  CovStorage
+};
 
 struct RenderSettings {
 
   // Display
   uint32_t numGaussians;
   int numRendered;
+  int numVisible;
+  int numOccluded = 0;
+  int numClusters = 0;
+  int numVisibleClusters = 0;
+  int numBudgetDropped = 0;
   int width;
   int height;
   glm::vec3 pos;
@@ -18,9 +44,99 @@ struct RenderSettings {
   float nearPlane = 0.1f;
   float farPlane = 1000.0f;
   bool enableCulling = true;
-  int tileSize = 16;
+  int tileSize = int(TileSize::Tile16x16); // TileSize, applied next frame
   float gaussianScale = 1.0f;
   bool showWireframe = false;
+  bool exactTileIntersection = true; // ellipse/tile test instead of the AABB
+  bool opacityAwareRadius = true;    // radius from the 1/255 alpha cutoff
+  bool subtileMasks = true;          // 4x4 coverage mask per tile instance
+  bool occlusionCulling = false;     // cull behind last frame's saturated tiles
+  float occlusionMaxMove = 0.05f;    // camera travel per frame, scene units
+  bool clusterCulling = true;        // frustum test per 256 Gaussian cluster
+
+  // Splat budget: past splatBudgetCount visible splats (or tile instances),
+  // only the most important ones by projected area x opacity are rendered
+  bool splatBudget = false;
+  int splatBudgetCount = 500000;
+  bool budgetInstances = false; // count tile instances instead of splats
+
+  // Dynamic resolution: the scene is rendered at renderScale of the window
+  // and upsampled. With dynamicResolution a PID controller on the GPU frame
+  // time moves renderScale between minRenderScale and 1 to hold targetFrameMs
+  bool dynamicResolution = false;
+  float renderScale = 1.0f; // of the next frame
+  float minRenderScale = 0.5f;
+  float targetFrameMs = 16.0f;
+  float resolutionKp = 0.2f;
+  float resolutionKi = 0.05f;
+  float resolutionKd = 0.05f;
+  float gpuFrameMs = 0.0f;
+  int renderWidth = 0; // render extent of the next frame, 0 before the first
+  int renderHeight = 0;
+
+  // Temporal sort reuse
+  bool temporalSort = false;
+  int sortRepairPasses = 4;
+  float sortMaxDisorder = 0.001f; // fraction of Gaussians left out of order
+  bool fullSort = true;
+  uint32_t sortInversions = 0;
+
+  // Rasterizer kernel (Rasterizer, stored as int for the ImGui combo)
+  int rasterizer = int(Rasterizer::Auto);
+  int activeRasterizer = int(Rasterizer::PerPixel);
+  float rasterTimeMs = 0.0f;
+  bool tileIdPerKey = true; // idkeys thread per key instead of per Gaussian
+  float tileIdTimeMs = 0.0f;
+  bool splitHeavyTiles = true;
+  // Rasterizers read pack_splats' records; off gathers the preprocess outputs
+  // per pixel, for comparison, and keeps every tile in one piece
+  bool packedSplats = true;
+  int tileChunkSize = 4096; // splats per work item of a split tile
+
+  // Render path (RenderMode) and the A/B report between the paths
+  int renderMode = int(RenderMode::Sorted);
+  float wboitDepthScale = 5.0f;   // view depth of the WBOIT weight falloff
+  float pathTimeMs[NUM_RENDER_MODES] = {}; // GPU time per path, 0 = not run
+  bool compareRequested = false;  // render every path next frame
+  // dB against the sorted path, negative until a comparison ran
+  float comparePsnr[NUM_RENDER_MODES] = {-1.0f, -1.0f, -1.0f};
+
+  // A/B check of one setting (SettingCheck) on the current view: each value
+  // renders a few frames on the sorted path, then its keys, GPU times and
+  // image error against the first value are reported. The camera must hold
+  // still meanwhile
+  int settingCheck = int(SettingCheck::None); // requested, None once started
+  bool settingCheckRunning = false;
+  std::string settingCheckReport = "";
+
+  // 3D covariance storage (CovPrecision) and the preprocess GPU time of each
+  int covPrecision = int(CovPrecision::None);
+  float preprocessTimeMs[NUM_COV_PRECISIONS] = {}; // 0 = not run
+
+  // View-dependent color reuse: SH is evaluated again once the view direction
+  // of a Gaussian moved more than colorCacheAngle degrees
+  bool colorCache = false;
+  float colorCacheAngle = 0.5f;
+
+  // SH level of detail: band 1 needs shLodRadius pixels and at most
+  // shLodDistance view depth, every further band twice the radius and half
+  // the depth. The counts are of the last frame, the error is the mean 8-bit
+  // color error of the reduced splats from the last measurement
+  bool shLod = false;
+  float shLodRadius = 2.0f;
+  float shLodDistance = 50.0f;
+  int numShEvals = 0;
+  int numShFetches = 0; // SH coefficients read
+  int numShReduced = 0;
+  float shLodError = -1.0f; // negative until measured
+  bool shLodReportRequested = false;
+
+  // Per-band SH planes, built at load time: per Gaussian the smallest degree
+  // whose dropped bands stay within shTolerance in every view direction
+  float shTolerance = 0.5f / 255.0f;
+  size_t shBytes = 0;
+  size_t shBytesDense = 0; // interleaved fixed degree layout, for comparison
+  int shDegreeMax = 0;     // of the loaded scene
 
   float exposure = 1.0f;
   float gamma = 2.2f;
@@ -28,7 +144,7 @@ struct RenderSettings {
 
   bool camRotationActive = false;
   std::string plyPath = "";
-  int shDegrees = -1;
+  int shDegrees = -1; // rendered SH degree, up to shDegreeMax
 
   float yaw = 0;
   float pitch = 0;
@@ -38,10 +154,35 @@ struct RenderSettings {
   bool sequenceMode = false;
   bool playing = false;
 
+  // Idle frames: once nothing in ImageInputs or the camera changed for a few
+  // rendered frames, the last scene image is re-presented under a fresh UI
+  // and the loop waits for input up to 1 / idleFps between frames
+  bool idleSkip = true;
+  int idleFps = 10;
+  bool idle = false; // the last frame was a re-presented one
+
   glm::mat4 baseReference = glm::mat4(1.0f);
   glm::mat4 currentReference = glm::mat4(1.0f);
   bool showAxis = false;
   std::string shaderPath = "";
+
+  // Settings the rendered image depends on besides the camera. The scale the
+  // resolution controller drives is left out, or its settling would keep the
+  // frames from ever going idle
+  auto ImageInputs() const {
+    return std::make_tuple(
+        nearPlane, farPlane, enableCulling, tileSize, gaussianScale,
+        showWireframe, exactTileIntersection, opacityAwareRadius,
+        subtileMasks, occlusionCulling, occlusionMaxMove, clusterCulling,
+        splatBudget, splatBudgetCount, budgetInstances, dynamicResolution,
+        dynamicResolution ? 0.0f : renderScale, temporalSort,
+        sortRepairPasses, sortMaxDisorder, rasterizer, tileIdPerKey,
+        splitHeavyTiles, packedSplats, tileChunkSize, renderMode,
+        wboitDepthScale, compareRequested, covPrecision, colorCache,
+        colorCacheAngle, shLod, shLodRadius, shLodDistance,
+        shLodReportRequested, exposure, gamma, saturation, shDegrees,
+        showAxis, baseReference, currentReference);
+  }
 };
 
 struct CameraKeyframe {
@@ -0,0 +1,84 @@
+// Vulkan 3DGS - Copyright (c) 2025 Alejandro Amat (github.com/AlejandroAmat) -
+// MIT Licensed
+
+#pragma once
+
+#include "RenderSettings.h"
+#include "VulkanContext.h"
+#include "utils.h"
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+// Hardware rasterization of the preprocessed splats as screen-space quads.
+// The sort-free path blends them with weighted blended OIT into two float
+// targets. The sorted quad path draws them in global depth order with
+// front-to-back premultiplied blending into the first target. The
+// WBOIT_RESOLVE compute pass turns either into the output image.
+class SplatRasterPipeline {
+public:
+  SplatRasterPipeline(VulkanContext &vkContext) : _vkContext(vkContext) {}
+  ~SplatRasterPipeline();
+
+  // extent is the size of the compute output image
+  void Init(const GaussianBuffers &buffers, VkExtent2D extent);
+  // Part of the attachments drawn to, for dynamic resolution. Viewport and
+  // scissor are dynamic state, so this needs no new pipelines
+  void SetRenderExtent(VkExtent2D extent) { _renderExtent = extent; }
+  // Front-to-back Gaussian indices for the sorted pass. The radix sort
+  // buffers are reallocated as they grow, so this is set again after a resize
+  void SetSortedList(VkBuffer sortedList);
+  void RecordWboitPass(VkCommandBuffer commandBuffer, uint32_t numVisible,
+                       float depthScale);
+  void RecordSortedPass(VkCommandBuffer commandBuffer, uint32_t numVisible);
+  void CleanUp();
+
+  VkImageView GetAccumView() const { return _accum.view; }
+  VkImageView GetRevealView() const { return _reveal.view; }
+
+private:
+  struct Attachment {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+  };
+
+  VulkanContext &_vkContext;
+  VkExtent2D _extent = {};
+  VkExtent2D _renderExtent = {};
+
+  Attachment _accum;  // WBOIT: sum(w * a * c), sum(w * a). Sorted: (C, 1 - T)
+  Attachment _reveal; // prod(1 - a)
+  VkRenderPass _wboitRenderPass = VK_NULL_HANDLE;
+  VkRenderPass _sortedRenderPass = VK_NULL_HANDLE;
+  VkFramebuffer _wboitFrameBuffer = VK_NULL_HANDLE;
+  VkFramebuffer _sortedFrameBuffer = VK_NULL_HANDLE;
+
+  VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+  VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
+  VkDescriptorSet _visibleSet = VK_NULL_HANDLE; // instances: visible list
+  VkDescriptorSet _sortedSet = VK_NULL_HANDLE;  // instances: depth order
+
+  VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline _wboitPipeline = VK_NULL_HANDLE;
+  VkPipeline _sortedPipeline = VK_NULL_HANDLE;
+
+  void CreateAttachment(Attachment &attachment, VkFormat format);
+  VkRenderPass CreateRenderPass(uint32_t numAttachments);
+  VkFramebuffer CreateFrameBuffer(VkRenderPass renderPass,
+                                  const std::vector<VkImageView> &views);
+  void CreateDescriptors(const GaussianBuffers &buffers);
+  void WriteBuffer(VkDescriptorSet set, uint32_t binding, VkBuffer buffer);
+  void CreatePipelineLayout();
+  VkPipeline CreatePipeline(
+      const std::string &fragShader, VkRenderPass renderPass,
+      const std::vector<VkPipelineColorBlendAttachmentState> &blendStates);
+  void RecordQuads(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+                   VkFramebuffer frameBuffer, VkPipeline pipeline,
+                   VkDescriptorSet set,
+                   const std::vector<VkClearValue> &clearValues,
+                   uint32_t numInstances, float depthScale);
+  VkShaderModule CreateShaderModule(const std::vector<char> &code);
+  uint32_t FindMemoryType(uint32_t typeFilter,
+                          VkMemoryPropertyFlags properties);
+};
@@ -44,6 +44,7 @@ class VulkanContext {
   int32_t SwapchainSize() const { return (int32_t)_vcxImages.size(); }
 
   VkCommandPool GetCommandPool() const { return _vcxCommandPool; }
+  const SubgroupInfo &GetSubgroupInfo() const { return _vcxSubgroupInfo; }
 
   ~VulkanContext();
 
@@ -71,8 +72,11 @@ class VulkanContext {
 
   VkCommandPool _vcxCommandPool;
 
+  SubgroupInfo _vcxSubgroupInfo;
+
   // get Functions
   void GetPhysicalDeviceInternal();
+  void QuerySubgroupInfo();
   QueueFamilyIndices GetQueueFamilies(VkPhysicalDevice device);
   SwapChainDetails GetSwapChainDetails(VkPhysicalDevice device);
 
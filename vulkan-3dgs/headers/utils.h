@@ -7,6 +7,7 @@
 #include <GLFW/glfw3.h>
 
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -49,12 +50,23 @@ struct InputArgs {
 };
 constexpr int AVG_GAUSS_TILE = 4;
 
+// Mirrors SplatRecord in Shaders/splat_record.glsl
+struct SplatRecord {
+  float xy[2];
+  uint32_t conicOpacity[2]; // fp16 x4
+  uint32_t colorSpare[2];   // fp16 rgb, 16 bits spare
+};
+static_assert(sizeof(SplatRecord) == 24, "SplatRecord must stay 24 bytes");
+
 struct GaussianBuffers {
   VkBuffer xyz;
   VkBuffer scales;
   VkBuffer rotations;
   VkBuffer opacity;
-  VkBuffer sh;
+  VkBuffer sh; // DC plane, see GaussianBase::BuildSHPlanes
+  VkBuffer shBand1;
+  VkBuffer shBand2;
+  VkBuffer shBand3;
   VkBuffer camUniform;
   VkBuffer radii;
   VkBuffer depth;
@@ -71,6 +83,25 @@ struct GaussianBuffers {
   VkBuffer values;
   VkBuffer ranges;
   VkBuffer histogram;
+  VkBuffer sortOrder;
+  VkBuffer counters;
+  VkBuffer visibleList;
+  VkBuffer records;
+  VkBuffer tileSplit;
+  VkBuffer tileWork;
+  VkBuffer partials;
+  VkBuffer partialDepths; // saturation depth next to each partial
+  VkBuffer activeTiles;
+  VkBuffer tileDepth;
+  VkBuffer colorCache; // last SH color and its view direction per Gaussian
+  VkBuffer clusterBounds;   // see GaussianBase::BuildClusters
+  VkBuffer visibleClusters; // written by cluster_cull.comp
+  VkBuffer budgetHistogram; // SPLAT_BUDGET_BINS counts, see splat_budget.comp
+  VkBuffer rowSpans;  // tile rows of the tall splats, see preprocess.comp
+  VkBuffer rowTables; // per Gaussian range in rowSpans
+  // Precomputed 3D covariances, created by ComputePipeline for the selected
+  // CovPrecision
+  VkBuffer cov3D = VK_NULL_HANDLE;
 };
 
 const std::vector<const char *> deviceExtensions = {
@@ -79,6 +110,15 @@ const std::vector<const char *> deviceExtensions = {
 const std::vector<const char *> validationLayers = {
     "VK_LAYER_KHRONOS_validation"};
 
+// Subgroup capabilities of the selected device, queried at startup
+struct SubgroupInfo {
+  uint32_t size = 32; // default subgroup size of compute shaders
+  uint32_t minSize = 32; // 1 when the device does not report it
+  uint32_t maxSize = 32;
+  bool sizeControl = false;   // compute pipelines can require a size
+  bool fullSubgroups = false; // ... and require full subgroups
+};
+
 struct QueueFamilyIndices {
   int graphicsFamily = -1;  // location
   int presentationFamily = -1;
@@ -32,6 +32,12 @@ void Application::Start() {
 
 void Application::Render() {
 
+  // After an idle frame, sleep until input arrives or the idle frame
+  // interval passes. The wait is kept out of the camera's deltaTime
+  if (g_renderSettings.idle) {
+    glfwWaitEventsTimeout(1.0 / std::max(g_renderSettings.idleFps, 1));
+    _frameTimer.lastTime = std::chrono::steady_clock::now();
+  }
   _frameTimer.UpdateTime();
   //_frameTimer.PrintStats();
   glfwPollEvents();
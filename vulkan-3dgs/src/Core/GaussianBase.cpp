@@ -1,2 +1,162 @@
 // Vulkan 3DGS - Copyright (c) 2024 Alejandro Amat (github.com/AlejandroAmat) - MIT Licensed
 
+#include "GaussianBase.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/constants.hpp>
+#include <limits>
+#include <stdexcept>
+
+// Spreads the low 21 bits of v to every third bit
+static uint64_t SpreadBits(uint64_t v) {
+  v &= 0x1FFFFF;
+  v = (v | v << 32) & 0x1F00000000FFFFull;
+  v = (v | v << 16) & 0x1F0000FF0000FFull;
+  v = (v | v << 8) & 0x100F00F00F00F00Full;
+  v = (v | v << 4) & 0x10C30C30C30C30C3ull;
+  v = (v | v << 2) & 0x1249249249249249ull;
+  return v;
+}
+
+template <typename T>
+static void Permute(std::vector<T> &data, const std::vector<uint32_t> &order,
+                    size_t stride = 1) {
+  if (data.size() < order.size() * stride) {
+    return;
+  }
+  std::vector<T> sorted(data.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    std::copy_n(data.begin() + order[i] * stride, stride,
+                sorted.begin() + i * stride);
+  }
+  data = std::move(sorted);
+}
+
+void GaussianBase::BuildClusters(uint32_t clusterSize) {
+  if (_numGaussians == 0 || !_clusterBounds.empty()) {
+    return;
+  }
+
+  glm::vec3 lo(std::numeric_limits<float>::max());
+  glm::vec3 hi(-std::numeric_limits<float>::max());
+  for (size_t i = 0; i < _numGaussians; i++) {
+    lo = glm::min(lo, glm::vec3(_xyz[i]));
+    hi = glm::max(hi, glm::vec3(_xyz[i]));
+  }
+  glm::vec3 cells = glm::vec3(float((1 << 21) - 1)) / glm::max(hi - lo, 1e-6f);
+
+  std::vector<std::pair<uint64_t, uint32_t>> codes(_numGaussians);
+  for (size_t i = 0; i < _numGaussians; i++) {
+    glm::uvec3 cell = glm::uvec3((glm::vec3(_xyz[i]) - lo) * cells);
+    codes[i] = {SpreadBits(cell.x) | SpreadBits(cell.y) << 1 |
+                    SpreadBits(cell.z) << 2,
+                uint32_t(i)};
+  }
+  std::sort(codes.begin(), codes.end());
+  std::vector<uint32_t> order(_numGaussians);
+  for (size_t i = 0; i < _numGaussians; i++) {
+    order[i] = codes[i].second;
+  }
+
+  Permute(_xyz, order);
+  Permute(_normals, order);
+  Permute(_opacities, order);
+  Permute(_scales, order);
+  Permute(_rotations, order);
+  Permute(_shCoefficients, order, size_t(3 * GetSHCoefficientsPerChannel()));
+
+  size_t numClusters = (_numGaussians + clusterSize - 1) / clusterSize;
+  _clusterBounds.resize(2 * numClusters);
+  for (size_t c = 0; c < numClusters; c++) {
+    glm::vec3 boxLo(std::numeric_limits<float>::max());
+    glm::vec3 boxHi(-std::numeric_limits<float>::max());
+    size_t end = std::min(_numGaussians, (c + 1) * clusterSize);
+    for (size_t i = c * clusterSize; i < end; i++) {
+      glm::vec3 s = glm::vec3(_scales[i]);
+      float extent = 3.0f * std::max(s.x, std::max(s.y, s.z));
+      boxLo = glm::min(boxLo, glm::vec3(_xyz[i]) - extent);
+      boxHi = glm::max(boxHi, glm::vec3(_xyz[i]) + extent);
+    }
+    _clusterBounds[2 * c] = glm::vec4(boxLo, 0.0f);
+    _clusterBounds[2 * c + 1] = glm::vec4(boxHi, 0.0f);
+  }
+  std::cout << "Clusters: " << numClusters << " of " << clusterSize
+            << " Gaussians" << std::endl;
+}
+
+// Words per plane entry: 3 floats per coefficient rounded up to uvec4s. The
+// band-1 entry keeps the band-2 and band-3 ranks in its spare words 9 and 10
+static const int SH_PLANE_WORDS[4] = {4, 12, 16, 24};
+
+void GaussianBase::BuildSHPlanes(float tolerance) {
+  if (!_shCoefficients.empty() && _shPlanes[0].empty()) {
+    const int coeffsPerGaussian = 3 * GetSHCoefficientsPerChannel();
+    size_t degreeCount[4] = {};
+    uint32_t rank[4] = {};
+
+    for (size_t i = 0; i < _numGaussians; i++) {
+      const float *coeffs = &_shCoefficients[i * coeffsPerGaussian];
+
+      // Band l adds at most |c_l| * sqrt((2l + 1) / 4pi) to a channel over
+      // all directions (addition theorem), so bands are dropped from the top
+      // while the summed bound stays within the tolerance
+      int degree = _shDegree;
+      glm::vec3 error(0.0f);
+      while (degree > 0) {
+        glm::vec3 norm2(0.0f);
+        for (int k = degree * degree; k < (degree + 1) * (degree + 1); k++) {
+          glm::vec3 c(coeffs[3 * k], coeffs[3 * k + 1], coeffs[3 * k + 2]);
+          norm2 += c * c;
+        }
+        float scale =
+            std::sqrt((2.0f * degree + 1.0f) / (4.0f * glm::pi<float>()));
+        glm::vec3 bound = error + glm::sqrt(norm2) * scale;
+        if (std::max(bound.x, std::max(bound.y, bound.z)) > tolerance) {
+          break;
+        }
+        error = bound;
+        degree--;
+      }
+      if (rank[1] >= (1u << 30)) {
+        throw std::runtime_error("SH band-1 rank exceeds 30 bits!");
+      }
+
+      uint32_t *entries[4] = {};
+      for (int band = 0; band <= degree; band++) {
+        std::vector<uint32_t> &plane = _shPlanes[band];
+        size_t start = plane.size();
+        plane.resize(start + SH_PLANE_WORDS[band], 0);
+        entries[band] = &plane[start];
+        int first = band * band;
+        std::memcpy(entries[band], coeffs + 3 * first,
+                    3 * (2 * band + 1) * sizeof(float));
+      }
+      entries[0][3] = rank[1] << 2 | uint32_t(degree);
+      if (degree > 0) {
+        entries[1][9] = rank[2];
+        entries[1][10] = rank[3];
+      }
+      for (int band = 1; band <= degree; band++) {
+        rank[band]++;
+      }
+      degreeCount[degree]++;
+    }
+
+    std::cout << "SH planes: Gaussians per degree";
+    for (int degree = 0; degree <= _shDegree; degree++) {
+      std::cout << " " << degree << ": " << degreeCount[degree];
+    }
+    std::cout << std::endl;
+  }
+
+  // Planes no Gaussian reaches still need a valid buffer
+  for (std::vector<uint32_t> &plane : _shPlanes) {
+    if (plane.empty()) {
+      plane.resize(4, 0);
+    }
+    plane.shrink_to_fit();
+  }
+  _shCoefficients.clear();
+  _shCoefficients.shrink_to_fit();
+}
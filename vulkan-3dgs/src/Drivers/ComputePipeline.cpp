@@ -15,16 +15,39 @@ void ComputePipeline::Initialize(GaussianBuffers gaussianBuffer) {
   CreateDescriptorPool();
 
   std::string shaderPath = g_renderSettings.shaderPath;
+  _subgroupSize = _vkContext.GetSubgroupInfo().size;
+  SetRenderScale(g_renderSettings.renderScale);
+  _upsample = UpsampleNeeded();
 
+  ApplyCovPrecision();
   CreateDescriptorSetLayout(PipelineType::PREPROCESS);
   CreateComputePipeline(shaderPath + "Shaders/preprocess.spv",
-                        PipelineType::PREPROCESS, 4);
+                        PipelineType::PREPROCESS, 15);
   SetupDescriptorSet(PipelineType::PREPROCESS);
   UpdateAllDescriptorSets(PipelineType::PREPROCESS);
 
+  CreateDescriptorSetLayout(PipelineType::COV3D);
+  CreateComputePipeline(shaderPath + "Shaders/cov3d.spv", PipelineType::COV3D,
+                        2);
+  SetupDescriptorSet(PipelineType::COV3D);
+  UpdateAllDescriptorSets(PipelineType::COV3D);
+
+  _numClusters = (_numGaussians + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+  CreateDescriptorSetLayout(PipelineType::CLUSTER_CULL);
+  CreateComputePipeline(shaderPath + "Shaders/cluster_cull.spv",
+                        PipelineType::CLUSTER_CULL, 3);
+  SetupDescriptorSet(PipelineType::CLUSTER_CULL);
+  UpdateAllDescriptorSets(PipelineType::CLUSTER_CULL);
+
+  CreateDescriptorSetLayout(PipelineType::SPLAT_BUDGET);
+  CreateComputePipeline(shaderPath + "Shaders/splat_budget.spv",
+                        PipelineType::SPLAT_BUDGET, 4);
+  SetupDescriptorSet(PipelineType::SPLAT_BUDGET);
+  UpdateAllDescriptorSets(PipelineType::SPLAT_BUDGET);
+
   CreateDescriptorSetLayout(PipelineType::PREFIXSUM);
   CreateComputePipeline(shaderPath + "Shaders/sum.spv", PipelineType::PREFIXSUM,
-                        3);
+                        4);
   SetupDescriptorSet(PipelineType::PREFIXSUM);
   UpdateAllDescriptorSets(PipelineType::PREFIXSUM);
 
@@ -35,7 +58,10 @@ void ComputePipeline::Initialize(GaussianBuffers gaussianBuffer) {
 
   CreateDescriptorSetLayout(PipelineType::ASSIGN_TILE_IDS);
   CreateComputePipeline(shaderPath + "Shaders/idkeys.spv",
-                        PipelineType::ASSIGN_TILE_IDS, 3);
+                        PipelineType::ASSIGN_TILE_IDS, 4);
+  _computePipelines[PipelineType::ASSIGN_TILE_IDS_GAUSSIAN] =
+      BuildComputePipeline(shaderPath + "Shaders/idkeys_gaussian.spv",
+                           _pipelineLayouts[PipelineType::ASSIGN_TILE_IDS]);
   SetupDescriptorSet(PipelineType::ASSIGN_TILE_IDS);
   UpdateAllDescriptorSets(PipelineType::ASSIGN_TILE_IDS);
 
@@ -44,7 +70,7 @@ void ComputePipeline::Initialize(GaussianBuffers gaussianBuffer) {
                         PipelineType::RADIX_HISTOGRAM_0, 4);
   CreateDescriptorSetLayout(PipelineType::RADIX_SCATTER_0);
   CreateComputePipeline(shaderPath + "Shaders/sort.spv",
-                        PipelineType::RADIX_SCATTER_0, 4);
+                        PipelineType::RADIX_SCATTER_0, 4, WORKGROUP_SIZE);
 
   SetupDescriptorSet(PipelineType::RADIX_HISTOGRAM_0);
   UpdateAllDescriptorSets(PipelineType::RADIX_HISTOGRAM_0);
@@ -58,6 +84,30 @@ void ComputePipeline::Initialize(GaussianBuffers gaussianBuffer) {
   SetupDescriptorSet(PipelineType::RADIX_SCATTER_1);
   UpdateAllDescriptorSets(PipelineType::RADIX_SCATTER_1);
 
+  CreateDescriptorSetLayout(PipelineType::DEPTH_KEYS);
+  CreateComputePipeline(shaderPath + "Shaders/depthkeys.spv",
+                        PipelineType::DEPTH_KEYS, 1);
+  SetupDescriptorSet(PipelineType::DEPTH_KEYS);
+  UpdateAllDescriptorSets(PipelineType::DEPTH_KEYS);
+
+  CreateDescriptorSetLayout(PipelineType::SORT_REPAIR);
+  CreateComputePipeline(shaderPath + "Shaders/repair.spv",
+                        PipelineType::SORT_REPAIR, 2);
+  SetupDescriptorSet(PipelineType::SORT_REPAIR);
+  UpdateAllDescriptorSets(PipelineType::SORT_REPAIR);
+
+  CreateDescriptorSetLayout(PipelineType::TILE_SPLIT);
+  CreateComputePipeline(shaderPath + "Shaders/tile_split.spv",
+                        PipelineType::TILE_SPLIT, 3);
+  SetupDescriptorSet(PipelineType::TILE_SPLIT);
+  UpdateAllDescriptorSets(PipelineType::TILE_SPLIT);
+
+  CreateDescriptorSetLayout(PipelineType::PACK_SPLATS);
+  CreateComputePipeline(shaderPath + "Shaders/pack_splats.spv",
+                        PipelineType::PACK_SPLATS, 3);
+  SetupDescriptorSet(PipelineType::PACK_SPLATS);
+  UpdateAllDescriptorSets(PipelineType::PACK_SPLATS);
+
   CreateDescriptorSetLayout(PipelineType::TILE_BOUNDARIES);
   CreateComputePipeline(shaderPath + "Shaders/boundaries.spv",
                         PipelineType::TILE_BOUNDARIES, 1);
@@ -65,25 +115,42 @@ void ComputePipeline::Initialize(GaussianBuffers gaussianBuffer) {
   UpdateAllDescriptorSets(PipelineType::TILE_BOUNDARIES);
 
   CreateDescriptorSetLayout(PipelineType::RENDER);
-#ifdef SHARED_MEM_RENDERING
-  CreateComputePipeline(shaderPath + "Shaders/render_shared.spv",
-                        PipelineType::RENDER, 4);
-#else
   CreateComputePipeline(shaderPath + "Shaders/render.spv", PipelineType::RENDER,
                         4);
-#endif
+  _computePipelines[PipelineType::RENDER_SHARED] =
+      BuildComputePipeline(shaderPath + "Shaders/render_shared.spv",
+                           _pipelineLayouts[PipelineType::RENDER],
+                           _tileSpec.width * _tileSpec.height);
+  _computePipelines[PipelineType::RENDER_QUAD] =
+      BuildComputePipeline(shaderPath + "Shaders/render_quad.spv",
+                           _pipelineLayouts[PipelineType::RENDER]);
+  _computePipelines[PipelineType::RENDER_CHUNK] =
+      BuildComputePipeline(shaderPath + "Shaders/render_chunk.spv",
+                           _pipelineLayouts[PipelineType::RENDER]);
+  _computePipelines[PipelineType::RENDER_MERGE] =
+      BuildComputePipeline(shaderPath + "Shaders/render_merge.spv",
+                           _pipelineLayouts[PipelineType::RENDER]);
+  _computePipelines[PipelineType::RENDER_GATHER] =
+      BuildComputePipeline(shaderPath + "Shaders/render_gather.spv",
+                           _pipelineLayouts[PipelineType::RENDER]);
   createRenderTarget();
   SetupDescriptorSet(PipelineType::RENDER);
   UpdateAllDescriptorSets(PipelineType::RENDER);
+  CreateTimestampQueries();
+
+  // Quad paths: graphics passes plus their resolve into the output
+  _splatRasterPipeline.Init(_gaussianBuffers, GetNativeExtent());
+  CreateDescriptorSetLayout(PipelineType::WBOIT_RESOLVE);
+  CreateComputePipeline(shaderPath + "Shaders/wboit_resolve.spv",
+                        PipelineType::WBOIT_RESOLVE, 3);
+  SetupDescriptorSet(PipelineType::WBOIT_RESOLVE);
+  UpdateAllDescriptorSets(PipelineType::WBOIT_RESOLVE);
 
-#ifdef __APPLE__
-  createRenderTarget();
   CreateDescriptorSetLayout(PipelineType::UPSAMPLING);
   CreateComputePipeline(shaderPath + "Shaders/upsample.spv",
-                        PipelineType::UPSAMPLING, 3);
+                        PipelineType::UPSAMPLING, 2);
   SetupDescriptorSet(PipelineType::UPSAMPLING);
   UpdateAllDescriptorSets(PipelineType::UPSAMPLING);
-#endif
   CreateSynchronization();
 
   // RecordAllCommandBuffers();
@@ -121,6 +188,11 @@ void ComputePipeline::CleanUp() {
 
   _commandBuffers.clear();
 
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkDestroyQueryPool(_vkContext.GetLogicalDevice(), _timestampPool, nullptr);
+    _timestampPool = VK_NULL_HANDLE;
+  }
+
   if (_computePipelines[PipelineType::DEBUG_RED_FILL] != VK_NULL_HANDLE) {
     vkDestroyPipeline(_vkContext.GetLogicalDevice(),
                       _computePipelines[PipelineType::DEBUG_RED_FILL], nullptr);
@@ -149,6 +221,12 @@ void ComputePipeline::CleanUp() {
     _descriptorSetLayouts[PipelineType::DEBUG_RED_FILL] = VK_NULL_HANDLE;
   }
 
+  if (_frameCache.image != VK_NULL_HANDLE) {
+    vkDestroyImage(_vkContext.GetLogicalDevice(), _frameCache.image, nullptr);
+    vkFreeMemory(_vkContext.GetLogicalDevice(), _frameCache.memory, nullptr);
+    _frameCache = {};
+  }
+
   std::cout << "ComputePipeline cleanup complete" << std::endl;
 }
 
@@ -242,17 +320,9 @@ void ComputePipeline::CreateDescriptorSetLayout(const PipelineType pType) {
 
 void ComputePipeline::CreateComputePipeline(std::string shaderName,
                                             const PipelineType pType,
-                                            int numPushConstants) {
+                                            int numPushConstants,
+                                            uint32_t subgroupInvocations) {
   std::cout << "  - Loading and creating compute pipeline..." << std::endl;
-  auto computeShaderCode = ReadFile(shaderName);
-  VkShaderModule computeShader = CreateShaderModule(computeShaderCode);
-
-  VkPipelineShaderStageCreateInfo computeShaderStageInfo = {};
-  computeShaderStageInfo.sType =
-      VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-  computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-  computeShaderStageInfo.module = computeShader;
-  computeShaderStageInfo.pName = "main";
 
   VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
   pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -283,19 +353,72 @@ void ComputePipeline::CreateComputePipeline(std::string shaderName,
     throw std::runtime_error("Failed to create pipeline layout!");
   }
 
+  _computePipelines[pType] = BuildComputePipeline(
+      shaderName, _pipelineLayouts[pType], subgroupInvocations);
+  std::cout << "Compute pipeline created for pipeline type " << (int)pType
+            << " using shader: " << shaderName << std::endl;
+}
+
+VkPipeline ComputePipeline::BuildComputePipeline(const std::string &shaderName,
+                                                 VkPipelineLayout layout,
+                                                 uint32_t subgroupInvocations) {
+  auto computeShaderCode = ReadFile(shaderName);
+  VkShaderModule computeShader = CreateShaderModule(computeShaderCode);
+
+  VkPipelineShaderStageCreateInfo computeShaderStageInfo = {};
+  computeShaderStageInfo.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  computeShaderStageInfo.module = computeShader;
+  computeShaderStageInfo.pName = "main";
+
+  // Shaders that do not declare these ids ignore them
+  const VkSpecializationMapEntry specEntries[] = {
+      {0, offsetof(TileSpecialization, width), sizeof(uint32_t)},
+      {1, offsetof(TileSpecialization, height), sizeof(uint32_t)},
+      {2, offsetof(TileSpecialization, quadWidth), sizeof(uint32_t)},
+      {3, offsetof(TileSpecialization, quadHeight), sizeof(uint32_t)},
+      {4, offsetof(SpecializationData, subgroupSize), sizeof(uint32_t)}};
+  // Kernels that size shared memory by SUBGROUP_SIZE pin the subgroup size to
+  // it when the device allows, and ask for full subgroups if the workgroup
+  // divides evenly. Otherwise the driver may launch any size down to the
+  // minimum, so they are specialized on that instead
+  const SubgroupInfo &subgroups = _vkContext.GetSubgroupInfo();
+  bool pinned = subgroupInvocations != 0 && subgroups.sizeControl;
+  SpecializationData specData = {_tileSpec,
+                                 pinned ? _subgroupSize : subgroups.minSize};
+  VkSpecializationInfo specInfo = {};
+  specInfo.mapEntryCount = 5;
+  specInfo.pMapEntries = specEntries;
+  specInfo.dataSize = sizeof(SpecializationData);
+  specInfo.pData = &specData;
+  computeShaderStageInfo.pSpecializationInfo = &specInfo;
+
+  VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT requiredSize = {};
+  requiredSize.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO_EXT;
+  requiredSize.requiredSubgroupSize = _subgroupSize;
+  if (pinned) {
+    computeShaderStageInfo.pNext = &requiredSize;
+    if (subgroups.fullSubgroups && subgroupInvocations % _subgroupSize == 0) {
+      computeShaderStageInfo.flags |=
+          VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT;
+    }
+  }
+
   VkComputePipelineCreateInfo pipelineInfo = {};
   pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-  pipelineInfo.layout = _pipelineLayouts[pType];
+  pipelineInfo.layout = layout;
   pipelineInfo.stage = computeShaderStageInfo;
 
+  VkPipeline pipeline;
   if (vkCreateComputePipelines(_vkContext.GetLogicalDevice(), VK_NULL_HANDLE, 1,
                                &pipelineInfo, nullptr,
-                               &_computePipelines[pType]) != VK_SUCCESS) {
+                               &pipeline) != VK_SUCCESS) {
     throw std::runtime_error("Failed to create compute pipeline!");
   }
   vkDestroyShaderModule(_vkContext.GetLogicalDevice(), computeShader, nullptr);
-  std::cout << "Compute pipeline created for pipeline type " << (int)pType
-            << " using shader: " << shaderName << std::endl;
+  return pipeline;
 }
 
 void ComputePipeline::SetupDescriptorSet(const PipelineType pType) {
@@ -340,6 +463,17 @@ void ComputePipeline::SetupDescriptorSet(const PipelineType pType) {
 void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
   VkCommandBuffer commandBuffer = _commandBuffers[imageIndex];
 
+  if (g_renderSettings.temporalSort && !_temporalSort) {
+    _rebuildSortOrder = true;
+  }
+  _temporalSort = g_renderSettings.temporalSort;
+
+  // The order rebuild sorts every Gaussian through the radix buffers
+  if (_temporalSort && _sizeBufferMax != 0 &&
+      _sizeBufferMax < uint32_t(_numGaussians)) {
+    resizeBuffers(_numGaussians * 1.25f);
+  }
+
   // Begin recording
   VkCommandBufferBeginInfo beginInfo = {};
   beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -348,6 +482,59 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
   if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
     throw std::runtime_error("Failed to begin recording command buffer!");
   }
+
+  // The previous frame's render work may still be reading the buffers we are
+  // about to overwrite
+  InsertMemoryBarrier(
+      commandBuffer,
+      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+          VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  // Reset the frame counters. With the temporal sort every Gaussian stays in
+  // the list in depth order, so the count and prefix sum dispatch are known
+  // up front; otherwise preprocess appends the visible ones and counts them
+  uint32_t counterInit[NUM_COUNTERS] = {};
+  counterInit[COUNTER_PREFIX_ARGS + 1] = 1;
+  counterInit[COUNTER_PREFIX_ARGS + 2] = 1;
+  counterInit[COUNTER_SPLIT_ARGS + 1] = 1;
+  counterInit[COUNTER_SPLIT_ARGS + 2] = 1;
+  counterInit[COUNTER_TILE_ARGS + 1] = 1;
+  counterInit[COUNTER_TILE_ARGS + 2] = 1;
+  counterInit[COUNTER_CLUSTER_ARGS + 1] = 1;
+  counterInit[COUNTER_CLUSTER_ARGS + 2] = 1;
+  counterInit[COUNTER_BUDGET_BIN] = SPLAT_BUDGET_BINS - 1;
+  if (_temporalSort) {
+    counterInit[COUNTER_VISIBLE] = uint32_t(_numGaussians);
+    counterInit[COUNTER_PREFIX_ARGS] = (_numGaussians + 255) / 256;
+  }
+  vkCmdUpdateBuffer(commandBuffer, _gaussianBuffers.counters, 0,
+                    sizeof(counterInit), counterInit);
+  // Preprocess never visits the Gaussians of culled clusters, so the outputs
+  // read per Gaussian by the later passes are cleared up front
+  _clusterCull =
+      g_renderSettings.clusterCulling && g_renderSettings.enableCulling;
+  if (_clusterCull) {
+    vkCmdFillBuffer(commandBuffer, _gaussianBuffers.radii, 0, VK_WHOLE_SIZE,
+                    0);
+    if (_temporalSort) {
+      vkCmdFillBuffer(commandBuffer, _gaussianBuffers.tilesTouched, 0,
+                      VK_WHOLE_SIZE, 0);
+    }
+  }
+  if (_clearColorCache) {
+    vkCmdFillBuffer(commandBuffer, _gaussianBuffers.colorCache, 0,
+                    VK_WHOLE_SIZE, 0);
+    _clearColorCache = false;
+  }
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                          VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                          VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
   /////////////////////////////////////////////////////////////////////////////////////
   // Transition image to GENERAL
   static std::vector<bool> firstFrame(_vkContext.GetSwapchainImages().size(),
@@ -365,6 +552,32 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdResetQueryPool(commandBuffer, _timestampPool,
+                        _preprocessQueryBase + 4 * imageIndex, 4);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        _timestampPool,
+                        _preprocessQueryBase + 4 * imageIndex + 2);
+  }
+  if (_cov3DDirty) {
+    RecordCov3DBuild(commandBuffer, imageIndex);
+  }
+
+  // Angle in degrees up to which a cached color is reused, > 1 disables
+  float colorCacheCos =
+      g_renderSettings.colorCache
+          ? std::cos(glm::radians(g_renderSettings.colorCacheAngle))
+          : 2.0f;
+
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        _timestampPool,
+                        _preprocessQueryBase + 4 * imageIndex);
+  }
+  if (_clusterCull) {
+    RecordClusterCull(commandBuffer, imageIndex);
+  }
+
   /////////////////////////////////////////////////////////////////////////////////////
   // Bind pipeline 1
 
@@ -376,9 +589,33 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
     float nearPlane;
     float farPlane;
     uint32_t culling;
-  } pushPreprocess = {_numGaussians, g_renderSettings.nearPlane,
+    uint32_t exactTiles;
+    uint32_t opacityRadius;
+    uint32_t compact;
+    uint32_t occlusion;
+    float occlusionMargin;
+    uint32_t covPrecision;
+    float colorCacheCos;
+    float shLodRadius;
+    float shLodDistance;
+    uint32_t shLodReport;
+    uint32_t clusters;
+  } pushPreprocess = {_numGaussians,
+                      g_renderSettings.nearPlane,
                       g_renderSettings.farPlane,
-                      uint32_t(g_renderSettings.enableCulling)};
+                      uint32_t(g_renderSettings.enableCulling),
+                      uint32_t(g_renderSettings.exactTileIntersection),
+                      uint32_t(g_renderSettings.opacityAwareRadius),
+                      uint32_t(!_temporalSort),
+                      uint32_t(_occlusionActive),
+                      _occlusionMargin,
+                      uint32_t(_covPrecision),
+                      colorCacheCos,
+                      g_renderSettings.shLod ? g_renderSettings.shLodRadius
+                                             : 0.0f,
+                      g_renderSettings.shLodDistance,
+                      uint32_t(_shLodReport),
+                      uint32_t(_clusterCull)};
   vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::PREPROCESS],
                      VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushPreprocess),
                      &pushPreprocess);
@@ -389,18 +626,34 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
       &_descriptorSets[PipelineType::PREPROCESS][imageIndex], 0, nullptr);
 
   uint32_t groupX = (_numGaussians + 255) / 256;
-  vkCmdDispatch(commandBuffer, groupX, 1, 1);
+  if (_clusterCull) {
+    vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                          COUNTER_CLUSTER_ARGS * sizeof(uint32_t));
+  } else {
+    vkCmdDispatch(commandBuffer, groupX, 1, 1);
+  }
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        _timestampPool,
+                        _preprocessQueryBase + 4 * imageIndex + 1);
+  }
 
   /////////////////////////////////////////////////////////////////////////////////////
-  // Barrier1
-  VkMemoryBarrier barrier = {};
-  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-  barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  // Barrier1 (the prefix sum dispatch size comes from the visible count)
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                          VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                          VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+
+  if (g_renderSettings.splatBudget) {
+    RecordSplatBudget(commandBuffer, imageIndex);
+  }
 
-  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0,
-                       nullptr, 0, nullptr);
+  if (_temporalSort) {
+    RecordSortOrderUpdate(commandBuffer, imageIndex);
+  }
 
   ///////////////////////////////////////////////////////////////////////////////////////
   //// Prefix Sum
@@ -412,21 +665,24 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
                           &_descriptorSets[PipelineType::PREFIXSUM][imageIndex],
                           0, nullptr);
 
-  uint32_t prefixSumGroups = (_numGaussians + 255) / 256;
-
+  // Runs over the visible Gaussians only; the last step also stores the total
+  // into COUNTER_NUM_RENDERED
   for (uint32_t step = 0; step <= _numSteps; step++) {
     struct PushConstants {
       uint32_t step;
       int32_t numElements;
       int32_t readFromA;
-    } pushConstants = {step, _numGaussians, (step % 2) == 0 ? 1 : 0};
+      uint32_t lastStep;
+    } pushConstants = {step, _numGaussians, (step % 2) == 0 ? 1 : 0,
+                       _numSteps};
 
     vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::PREFIXSUM],
                        VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants),
                        &pushConstants);
-    vkCmdDispatch(commandBuffer, prefixSumGroups, 1, 1);
+    vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                          COUNTER_PREFIX_ARGS * sizeof(uint32_t));
 
-    if (step < _numSteps - 1) {
+    if (step < _numSteps) {
       VkMemoryBarrier stepBarrier = {};
       stepBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
       stepBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
@@ -437,14 +693,26 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
     }
   }
 
-  VkBufferCopy copyRegion = {};
-  copyRegion.srcOffset = (_numGaussians - 1) * sizeof(uint32_t);
-  copyRegion.dstOffset = 0;
-  copyRegion.size = sizeof(uint32_t);
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        _timestampPool,
+                        _preprocessQueryBase + 4 * imageIndex + 3);
+  }
+
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_TRANSFER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT);
 
-  vkCmdCopyBuffer(commandBuffer, _resultBufferPrefix,
+  VkBufferCopy copyRegion = {};
+  copyRegion.size = sizeof(uint32_t) * NUM_COUNTERS;
+  vkCmdCopyBuffer(commandBuffer, _gaussianBuffers.counters,
                   _gaussianBuffers.numRendered.staging, 1, &copyRegion);
 
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_HOST_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_HOST_BIT);
+
   ///////////////////// END PREFIX SUM /////////////////////
 
   /////////////////////////////////////////////////////////////////////////////////////
@@ -460,7 +728,9 @@ void ComputePipeline::RecordCommandPreprocess(uint32_t imageIndex) {
 }
 
 void ComputePipeline::RecordCommandRender(uint32_t imageIndex, int numRendered,
-                                          Camera &cam) {
+                                          Camera &cam, bool fullSort,
+                                          RenderMode mode, bool compare,
+                                          bool cacheFrame, int captureSlot) {
   VkCommandBuffer commandBuffer = _renderCommandBuffers[imageIndex];
 
   // Begin recording
@@ -472,195 +742,50 @@ void ComputePipeline::RecordCommandRender(uint32_t imageIndex, int numRendered,
     throw std::runtime_error("Failed to begin recording command buffer!");
   }
 
-  if (numRendered) {
-
-#ifdef __APPLE__
-    TransitionImage(
-        commandBuffer,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, // From previous frame
-        VK_IMAGE_LAYOUT_GENERAL,                  // For compute write
-        _renderTarget.image, VK_ACCESS_SHADER_READ_BIT,
-        VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-#endif
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                      _computePipelines[PipelineType::ASSIGN_TILE_IDS]);
-
-    VkExtent2D extent = _vkContext.GetSwapchainExtent();
-    uint32_t tileX = (extent.width / _windowResize + 15) / 16;
-    struct {
-      uint32_t tile;
-      int32_t nGauss;
-      uint32_t culling;
-    } pushCt = {tileX, _numGaussians, 1};
-    vkCmdPushConstants(commandBuffer,
-                       _pipelineLayouts[PipelineType::ASSIGN_TILE_IDS],
-                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushCt), &pushCt);
-
-    vkCmdBindDescriptorSets(
-        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-        _pipelineLayouts[PipelineType::ASSIGN_TILE_IDS], 0, 1,
-        &_descriptorSets[PipelineType::ASSIGN_TILE_IDS][imageIndex], 0,
-        nullptr);
-
-    vkCmdDispatch(commandBuffer, (_numGaussians + 255) / 256, 1, 1);
-
-    VkMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT; // For presentation
-
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1, &barrier,
-                         0, nullptr, 0, nullptr);
-
-    ////////////////////////////////////////////////////////////////////////////////////////
-
-    VkMemoryBarrier barrier_t = {};
-    barrier_t.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier_t.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barrier_t.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT; // For presentation
-
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1, &barrier_t,
-                         0, nullptr, 0, nullptr);
-    uint32_t numElementsToSort = numRendered;
-
-    uint32_t elementsPerWorkgroup =
-        WORKGROUP_SIZE * blocks_per_workgroup; // 256 * 32 = 8192
-    uint32_t numWorkgroups =
-        (numElementsToSort + elementsPerWorkgroup - 1) / elementsPerWorkgroup;
-
-    // Prepare push constants
-    struct RadixPushConstants {
-      uint32_t g_num_elements;
-      uint32_t g_shift;
-      uint32_t g_num_workgroups;
-      uint32_t g_num_blocks_per_workgroup;
-    } radixPC;
-
-    radixPC.g_num_elements = numElementsToSort;
-    radixPC.g_num_workgroups = numWorkgroups;
-    radixPC.g_num_blocks_per_workgroup = blocks_per_workgroup;
-
-    // Perform 6 passes of radix sort (tiles_ID always can be represented with
-    // 2 bits)
-    for (uint32_t pass = 0; pass < 6; pass++) {
-      radixPC.g_shift = pass * 8;
-
-      bool isEven = (pass % 2 == 0);
-
-      // HISTOGRAM PASS
-      PipelineType histType = isEven ? PipelineType::RADIX_HISTOGRAM_0
-                                     : PipelineType::RADIX_HISTOGRAM_1;
-
-      vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                        _computePipelines[PipelineType::RADIX_HISTOGRAM_0]);
-      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                              _pipelineLayouts[PipelineType::RADIX_HISTOGRAM_0],
-                              0, 1, &_descriptorSets[histType][imageIndex], 0,
-                              nullptr);
-      vkCmdPushConstants(
-          commandBuffer, _pipelineLayouts[PipelineType::RADIX_HISTOGRAM_0],
-          VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RadixPushConstants), &radixPC);
-      vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
-
-      VkMemoryBarrier histBarrier = {};
-      histBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-      histBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-      histBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-      vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
-                           &histBarrier, 0, nullptr, 0, nullptr);
+  // Results of this image's previous frame, read before the queries reset
+  ReadRenderTimestamps(imageIndex);
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdResetQueryPool(commandBuffer, _timestampPool,
+                        TIMESTAMPS_PER_IMAGE * imageIndex,
+                        TIMESTAMPS_PER_IMAGE);
+  }
 
-      // SCATTER PASS
-      PipelineType scatterType = isEven ? PipelineType::RADIX_SCATTER_0
-                                        : PipelineType::RADIX_SCATTER_1;
+  if (numRendered) {
 
-      vkCmdBindPipeline(
-          commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-          _computePipelines[PipelineType::RADIX_SCATTER_0]); // Use same
-                                                             // pipeline
-      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                              _pipelineLayouts[PipelineType::RADIX_SCATTER_0],
-                              0, 1, &_descriptorSets[scatterType][imageIndex],
-                              0, nullptr);
-      vkCmdPushConstants(
-          commandBuffer, _pipelineLayouts[PipelineType::RADIX_SCATTER_0],
-          VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RadixPushConstants), &radixPC);
-      vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
-
-      if (pass < 5) {
-        VkMemoryBarrier scatterBarrier = {};
-        scatterBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-        scatterBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-        scatterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        vkCmdPipelineBarrier(commandBuffer,
-                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
-                             &scatterBarrier, 0, nullptr, 0, nullptr);
+    if (_upsample) {
+      TransitionImage(
+          commandBuffer,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, // From previous frame
+          VK_IMAGE_LAYOUT_GENERAL,                  // For compute write
+          _renderTarget.image, VK_ACCESS_SHADER_READ_BIT,
+          VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+    // A comparison runs the other paths first; the selected one is what ends
+    // up on screen
+    if (compare) {
+      for (uint32_t other = 0; other < NUM_RENDER_MODES; other++) {
+        if (RenderMode(other) == mode) {
+          continue;
+        }
+        RecordRenderPath(commandBuffer, imageIndex, numRendered, fullSort,
+                         RenderMode(other));
+        RecordOutputCapture(commandBuffer, imageIndex, other);
       }
     }
+    RecordRenderPath(commandBuffer, imageIndex, numRendered, fullSort, mode);
+    if (_timestampPool != VK_NULL_HANDLE) {
+      _displayedMode[imageIndex] = mode;
+    }
+    if (compare || captureSlot >= 0) {
+      RecordOutputCapture(commandBuffer, imageIndex,
+                          compare ? uint32_t(mode) : uint32_t(captureSlot));
+      InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                          VK_ACCESS_HOST_READ_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_HOST_BIT);
+    }
 
-    VkMemoryBarrier finalSortBarrier = {};
-    finalSortBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    finalSortBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    finalSortBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
-                         &finalSortBarrier, 0, nullptr, 0, nullptr);
-
-    /////////////////////////////////////////////////////////////////////////////////////////
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                      _computePipelines[PipelineType::TILE_BOUNDARIES]);
-
-    vkCmdPushConstants(
-        commandBuffer, _pipelineLayouts[PipelineType::TILE_BOUNDARIES],
-        VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &numRendered);
-
-    // Bind descriptor set
-    vkCmdBindDescriptorSets(
-        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-        _pipelineLayouts[PipelineType::TILE_BOUNDARIES], 0, 1,
-        &_descriptorSets[PipelineType::TILE_BOUNDARIES][imageIndex], 0,
-        nullptr);
-
-    vkCmdDispatch(commandBuffer, (numRendered + 255) / 256, 1, 1);
-
-    VkMemoryBarrier tilesBarrier = {};
-    tilesBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    tilesBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    tilesBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
-                         &tilesBarrier, 0, nullptr, 0, nullptr);
-
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    clearSwapchain(commandBuffer, imageIndex, true);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                      _computePipelines[PipelineType::RENDER]);
-
-    struct {
-      uint32_t w;
-      uint32_t h;
-      uint32_t wireframe;
-      float gaussScale;
-    } pcRender = {extent.width / _windowResize, extent.height / _windowResize,
-                  uint32_t(g_renderSettings.showWireframe),
-                  g_renderSettings.gaussianScale};
-
-    vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::RENDER],
-                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pcRender),
-                       &pcRender);
-
-    // Bind descriptor set
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            _pipelineLayouts[PipelineType::RENDER], 0, 1,
-                            &_descriptorSets[PipelineType::RENDER][imageIndex],
-                            0, nullptr);
-
-    vkCmdDispatch(commandBuffer, (extent.width / _windowResize + 15) / 16,
-                  (extent.height / _windowResize + 15) / 16, 1);
     ///////////////////////////////////////////////////////////////////////////////////////
     VkMemoryBarrier barrier_x = {};
     barrier_x.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
@@ -671,39 +796,56 @@ void ComputePipeline::RecordCommandRender(uint32_t imageIndex, int numRendered,
                          VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1, &barrier_x,
                          0, nullptr, 0, nullptr);
 
-/////////////////////////////////////////////////////////////////////////
-// Apple upsampling
-#ifdef __APPLE__
-    TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_GENERAL,
-                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                    _renderTarget.image, VK_ACCESS_SHADER_WRITE_BIT,
-                    VK_ACCESS_SHADER_READ_BIT,
-                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    /////////////////////////////////////////////////////////////////////////
+    // Upsampling of the render extent to the swapchain
+    if (_upsample) {
+      TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_GENERAL,
+                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                      _renderTarget.image, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                      _computePipelines[PipelineType::UPSAMPLING]);
-
-    vkCmdBindDescriptorSets(
-        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-        _pipelineLayouts[PipelineType::UPSAMPLING], 0, 1,
-        &_descriptorSets[PipelineType::UPSAMPLING][imageIndex], 0, nullptr);
-    vkCmdDispatch(commandBuffer, (extent.width + 15) / 16,
-                  (extent.height + 15) / 16, 1);
+      vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                        _computePipelines[PipelineType::UPSAMPLING]);
 
-    VkMemoryBarrier barrier_upsample = {};
-    barrier_upsample.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier_upsample.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barrier_upsample.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+      vkCmdBindDescriptorSets(
+          commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+          _pipelineLayouts[PipelineType::UPSAMPLING], 0, 1,
+          &_descriptorSets[PipelineType::UPSAMPLING][imageIndex], 0, nullptr);
+      vkCmdPushConstants(commandBuffer,
+                         _pipelineLayouts[PipelineType::UPSAMPLING],
+                         VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(_renderExtent),
+                         &_renderExtent);
+      VkExtent2D extent = _vkContext.GetSwapchainExtent();
+      vkCmdDispatch(commandBuffer, (extent.width + 15) / 16,
+                    (extent.height + 15) / 16, 1);
+
+      VkMemoryBarrier barrier_upsample = {};
+      barrier_upsample.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+      barrier_upsample.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+      barrier_upsample.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
 
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1,
-                         &barrier_upsample, 0, nullptr, 0, nullptr);
-#endif
+      vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1,
+                           &barrier_upsample, 0, nullptr, 0, nullptr);
+    }
   } else {
 
     clearSwapchain(commandBuffer, imageIndex);
   }
+  if (cacheFrame) {
+    RecordFrameCache(commandBuffer, imageIndex);
+  }
+  RecordOverlays(commandBuffer, imageIndex, cam);
+
+  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to record command buffer!");
+  }
+}
+
+void ComputePipeline::RecordOverlays(VkCommandBuffer commandBuffer,
+                                     uint32_t imageIndex, Camera &cam) {
   TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_GENERAL,
                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
                   _vkContext.GetSwapchainImages()[imageIndex].image,
@@ -732,106 +874,917 @@ void ComputePipeline::RecordCommandRender(uint32_t imageIndex, int numRendered,
                   VK_ACCESS_MEMORY_READ_BIT,
                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+}
 
-  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
-    throw std::runtime_error("Failed to record command buffer!");
+void ComputePipeline::RecordFrameCache(VkCommandBuffer commandBuffer,
+                                       uint32_t imageIndex) {
+  if (_frameCache.image == VK_NULL_HANDLE) {
+    CreateFrameCache();
   }
+  VkImage swapchainImage = _vkContext.GetSwapchainImages()[imageIndex].image;
+
+  InsertMemoryBarrier(commandBuffer,
+                      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_TRANSFER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT);
+  // The previous cached frame is discarded
+  TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED,
+                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, _frameCache.image,
+                  VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  VkExtent2D extent = _vkContext.GetSwapchainExtent();
+  VkImageCopy region = {};
+  region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.dstSubresource = region.srcSubresource;
+  region.extent = {extent.width, extent.height, 1};
+  vkCmdCopyImage(commandBuffer, swapchainImage, VK_IMAGE_LAYOUT_GENERAL,
+                 _frameCache.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                 &region);
+
+  TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _frameCache.image,
+                  VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT);
+  // The overlays' transition of the swapchain image waits for the copy
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_READ_BIT,
+                      VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+  _frameCache.valid = true;
 }
 
-VkShaderModule
-ComputePipeline::CreateShaderModule(const std::vector<char> &code) {
-  VkShaderModuleCreateInfo shaderCreateInfo = {};
-  shaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  shaderCreateInfo.codeSize = code.size();
-  shaderCreateInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+void ComputePipeline::CreateFrameCache() {
+  VkDevice device = _vkContext.GetLogicalDevice();
+  VkExtent2D extent = _vkContext.GetSwapchainExtent();
 
-  VkShaderModule shaderModule;
-  if (vkCreateShaderModule(_vkContext.GetLogicalDevice(), &shaderCreateInfo,
-                           nullptr, &shaderModule) != VK_SUCCESS)
-    throw std::runtime_error("Fail Creating Shader Module");
+  VkImageCreateInfo imageInfo = {};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = _vkContext.GetSwapchainFormat();
+  imageInfo.extent = {extent.width, extent.height, 1};
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage =
+      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (vkCreateImage(device, &imageInfo, nullptr, &_frameCache.image) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create frame cache image!");
+  }
 
-  return shaderModule;
+  VkMemoryRequirements memRequirements;
+  vkGetImageMemoryRequirements(device, _frameCache.image, &memRequirements);
+  VkMemoryAllocateInfo allocInfo = {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = memRequirements.size;
+  allocInfo.memoryTypeIndex = findMemoryType(
+      memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  if (vkAllocateMemory(device, &allocInfo, nullptr, &_frameCache.memory) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to allocate frame cache memory!");
+  }
+  vkBindImageMemory(device, _frameCache.image, _frameCache.memory, 0);
 }
 
-void ComputePipeline::TransitionImage(VkCommandBuffer commandBuffer,
-                                      VkImageLayout in, VkImageLayout out,
-                                      VkImage image, VkAccessFlags src,
-                                      VkAccessFlags dst,
-                                      VkPipelineStageFlagBits srcStage,
-                                      VkPipelineStageFlagBits dstStage) {
+void ComputePipeline::RecordRenderPath(VkCommandBuffer commandBuffer,
+                                       uint32_t imageIndex, int numRendered,
+                                       bool fullSort, RenderMode mode) {
+  uint32_t query = TIMESTAMPS_PER_IMAGE * imageIndex + 4 + 2 * uint32_t(mode);
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        _timestampPool, query);
+  }
 
-  // Transition swapchain image to GENERAL layout for compute write
-  VkImageMemoryBarrier barrier = {};
-  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER; // Type of barrier
-  barrier.oldLayout = in;  // Don't care about previous contents
-  barrier.newLayout = out; // Layout for compute shader access
-  barrier.srcQueueFamilyIndex =
-      VK_QUEUE_FAMILY_IGNORED; // Not transferring between queue families
-  barrier.dstQueueFamilyIndex =
-      VK_QUEUE_FAMILY_IGNORED; // Not transferring between queue families
-  barrier.image = image;       // The specific swapchain image
-  barrier.subresourceRange.aspectMask =
-      VK_IMAGE_ASPECT_COLOR_BIT;               // Color data (not depth/stencil)
-  barrier.subresourceRange.baseMipLevel = 0;   // Mipmap level 0
-  barrier.subresourceRange.levelCount = 1;     // Only 1 mipmap level
-  barrier.subresourceRange.baseArrayLayer = 0; // Array layer 0
-  barrier.subresourceRange.layerCount = 1;     // Only 1 array layer
-  barrier.srcAccessMask = src;                 // No previous access to wait for
-  barrier.dstAccessMask = dst;                 // Compute shader will write
+  if (mode == RenderMode::SortFree) {
+    RecordSortFreePath(commandBuffer, imageIndex);
+  } else if (mode == RenderMode::SortedQuads) {
+    RecordSortedQuadPath(commandBuffer, imageIndex);
+  } else {
+    RecordSortedPath(commandBuffer, imageIndex, numRendered, fullSort);
+  }
 
-  vkCmdPipelineBarrier(
-      commandBuffer, // Command buffer to record into
-      srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1,
-      &barrier); // 1 image barrier, no memory/buffer barriers //
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        _timestampPool, query + 1);
+    _pathTimestampMask[imageIndex] |= 1u << uint32_t(mode);
+  }
 }
 
-void ComputePipeline::RenderFrame(Camera &cam) {
-
-  vkWaitForFences(_vkContext.GetLogicalDevice(), 1,
-                  &_renderFences[_currentFrame], VK_TRUE, UINT64_MAX);
+void ComputePipeline::RecordSortedPath(VkCommandBuffer commandBuffer,
+                                       uint32_t imageIndex, int numRendered,
+                                       bool fullSort) {
+  bool perKey = g_renderSettings.tileIdPerKey;
+  vkCmdBindPipeline(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _computePipelines[perKey ? PipelineType::ASSIGN_TILE_IDS
+                               : PipelineType::ASSIGN_TILE_IDS_GAUSSIAN]);
 
-  vkResetFences(_vkContext.GetLogicalDevice(), 1,
-                &_preprocessFences[_currentFrame]);
+  VkExtent2D tileGrid = GetTileGrid();
+  uint32_t tileX = tileGrid.width;
+  struct {
+    uint32_t tile;
+    uint32_t numRendered;
+    uint32_t exactTiles;
+    uint32_t opacityRadius;
+  } pushCt = {tileX, uint32_t(numRendered),
+              uint32_t(g_renderSettings.exactTileIntersection),
+              uint32_t(g_renderSettings.opacityAwareRadius)};
+  vkCmdPushConstants(commandBuffer,
+                     _pipelineLayouts[PipelineType::ASSIGN_TILE_IDS],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushCt), &pushCt);
 
-  uint32_t imageIndex;
-  VkResult result = vkAcquireNextImageKHR(
-      _vkContext.GetLogicalDevice(), _vkContext.GetSwapchain(), UINT64_MAX,
-      _semaphores[_currentFrame], VK_NULL_HANDLE, &imageIndex);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::ASSIGN_TILE_IDS], 0, 1,
+      &_descriptorSets[PipelineType::ASSIGN_TILE_IDS][imageIndex], 0, nullptr);
 
-  if (result != VK_SUCCESS) {
-    throw std::runtime_error("Failed to acquire swapchain image!");
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        _timestampPool, TIMESTAMPS_PER_IMAGE * imageIndex + 2);
   }
 
-  vkResetCommandBuffer(_commandBuffers[imageIndex], 0);
-  vkResetCommandBuffer(_renderCommandBuffers[imageIndex], 0);
-  RecordCommandPreprocess(imageIndex);
-  submitCommandBuffer(imageIndex);
+  // Thread per key, or per visible Gaussian over the prefix sum's groups.
+  // Both shaders grid-stride past the dispatch limit
+  if (perKey) {
+    uint32_t keyGroups =
+        std::min((uint32_t(numRendered) + 255) / 256, 65535u);
+    vkCmdDispatch(commandBuffer, keyGroups, 1, 1);
+  } else {
+    vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                          COUNTER_PREFIX_ARGS * sizeof(uint32_t));
+  }
 
-  vkWaitForFences(_vkContext.GetLogicalDevice(), 1,
-                  &_preprocessFences[_currentFrame], VK_TRUE, UINT64_MAX);
+  InsertMemoryBarrier(commandBuffer);
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        _timestampPool, TIMESTAMPS_PER_IMAGE * imageIndex + 3);
+  }
 
-  uint32_t totalRendered = ReadFinalPrefixSum();
-  g_renderSettings.numRendered = totalRendered;
+  // Keys coming out of a repaired temporal order are already front to back
+  // inside each tile, so the stable radix sort only has to order tile IDs
+  if (fullSort) {
+    RecordRadixSort(commandBuffer, imageIndex, numRendered, 0,
+                    4 + GetTileSortPasses());
+  } else {
+    RecordRadixSort(commandBuffer, imageIndex, numRendered, 32,
+                    GetTileSortPasses());
+  }
 
-  if (totalRendered > _sizeBufferMax) {
-    resizeBuffers(totalRendered * 1.25f);
+  VkMemoryBarrier finalSortBarrier = {};
+  finalSortBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  finalSortBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  finalSortBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &finalSortBarrier, 0, nullptr, 0, nullptr);
+
+  // Gather the splat data into sorted order so the rasterizers read one
+  // linear stream per tile instead of gathering through gaussianId. Without
+  // packing, render_gather does that gather per pixel instead
+  bool packed = g_renderSettings.packedSplats;
+  if (packed) {
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      _computePipelines[PipelineType::PACK_SPLATS]);
+    struct {
+      uint32_t numRendered;
+      uint32_t tilesX;
+      uint32_t subtileMasks;
+    } pcPack = {uint32_t(numRendered), tileX,
+                uint32_t(g_renderSettings.subtileMasks)};
+    vkCmdPushConstants(commandBuffer,
+                       _pipelineLayouts[PipelineType::PACK_SPLATS],
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pcPack),
+                       &pcPack);
+    vkCmdBindDescriptorSets(
+        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        _pipelineLayouts[PipelineType::PACK_SPLATS], 0, 1,
+        &_descriptorSets[PipelineType::PACK_SPLATS][imageIndex], 0, nullptr);
+    vkCmdDispatch(commandBuffer,
+                  std::min((uint32_t(numRendered) + 255) / 256, 65535u), 1,
+                  1);
   }
 
-  vkResetFences(_vkContext.GetLogicalDevice(), 1,
-                &_renderFences[_currentFrame]);
+  // Tile boundaries and the packed records are independent; one barrier
+  // after tile boundaries covers both
 
-  RecordCommandRender(imageIndex, totalRendered, cam);
-  submitCommandBuffer(imageIndex, false);
+  /////////////////////////////////////////////////////////////////////////////////////////
+  // Tile boundaries only writes the tiles that have keys, the rasterizers
+  // only fold saturation depths into the tiles they render
+  vkCmdFillBuffer(commandBuffer, _gaussianBuffers.ranges, 0, VK_WHOLE_SIZE, 0);
+  vkCmdFillBuffer(commandBuffer, _gaussianBuffers.tileDepth, 0, VK_WHOLE_SIZE,
+                  0);
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
-  VkPresentInfoKHR presentInfo = {};
-  presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-  VkSemaphore waitSemaphores[] = {_renderSemaphores[imageIndex]};
-  presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores = waitSemaphores;
-  presentInfo.swapchainCount = 1;
-  VkSwapchainKHR swapchains[] = {_vkContext.GetSwapchain()};
-  presentInfo.pSwapchains = swapchains;
-  presentInfo.pImageIndices = &imageIndex;
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::TILE_BOUNDARIES]);
+
+  vkCmdPushConstants(
+      commandBuffer, _pipelineLayouts[PipelineType::TILE_BOUNDARIES],
+      VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &numRendered);
+
+  // Bind descriptor set
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::TILE_BOUNDARIES], 0, 1,
+      &_descriptorSets[PipelineType::TILE_BOUNDARIES][imageIndex], 0, nullptr);
+
+  vkCmdDispatch(commandBuffer,
+                std::min((uint32_t(numRendered) + 255) / 256, 65535u), 1, 1);
+
+  VkMemoryBarrier tilesBarrier = {};
+  tilesBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  tilesBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  tilesBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                       &tilesBarrier, 0, nullptr, 0, nullptr);
+
+  // Tiles with more splats than the chunk size are cut into work items for
+  // render_chunk, so one crowded tile no longer holds up the whole dispatch.
+  // The wireframe overlay paints splats over each other instead of blending
+  // front to back, so render_merge cannot chain its chunks: those frames keep
+  // every tile in one piece. The chunks read the packed records
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::TILE_SPLIT]);
+  bool split = g_renderSettings.splitHeavyTiles &&
+               !g_renderSettings.showWireframe && packed;
+  struct {
+    uint32_t numTiles;
+    uint32_t chunkSize;
+    uint32_t maxChunks;
+  } pcSplit = {tileGrid.width * tileGrid.height,
+               split ? uint32_t(std::max(g_renderSettings.tileChunkSize, 1))
+                     : std::numeric_limits<uint32_t>::max(),
+               std::min(MAX_SPLIT_WORK,
+                        MAX_SPLIT_CHUNKS * MAX_TILE_PIXELS /
+                            (_tileSpec.width * _tileSpec.height))};
+  vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::TILE_SPLIT],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pcSplit), &pcSplit);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::TILE_SPLIT], 0, 1,
+      &_descriptorSets[PipelineType::TILE_SPLIT][imageIndex], 0, nullptr);
+  vkCmdDispatch(commandBuffer, (pcSplit.numTiles + 255) / 256, 1, 1);
+
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT |
+                          VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                          VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+
+  ///////////////////////////////////////////////////////////////////////////////////////////
+  // Only non-empty tiles are dispatched, so the clear is the final color of
+  // the empty ones
+  clearSwapchain(commandBuffer, imageIndex, true);
+  if (_upsample) {
+    VkClearColorValue clearColor = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    VkImageSubresourceRange targetRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0,
+                                           1};
+    vkCmdClearColorImage(commandBuffer, _renderTarget.image,
+                         VK_IMAGE_LAYOUT_GENERAL, &clearColor, 1,
+                         &targetRange);
+  }
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+  // The gather kernel stands in for every rasterizer and stays out of the
+  // Auto benchmark, which Rasterizer::Auto marks in _timestampKernel
+  Rasterizer rasterizer = Rasterizer::Auto;
+  PipelineType kernel = PipelineType::RENDER_GATHER;
+  if (packed) {
+    rasterizer = SelectRasterizer();
+    g_renderSettings.activeRasterizer = int(rasterizer);
+    kernel = _rasterKernels.at(rasterizer);
+  }
+
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        _timestampPool, TIMESTAMPS_PER_IMAGE * imageIndex);
+  }
+
+  // All rasterizer kernels share the RENDER layout and descriptor sets
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[kernel]);
+
+  struct {
+    uint32_t w;
+    uint32_t h;
+    uint32_t wireframe;
+    float gaussScale;
+  } pcRender = {_renderExtent.width, _renderExtent.height,
+                uint32_t(g_renderSettings.showWireframe),
+                g_renderSettings.gaussianScale};
+
+  vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::RENDER],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pcRender),
+                     &pcRender);
+
+  // Bind descriptor set
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          _pipelineLayouts[PipelineType::RENDER], 0, 1,
+                          &_descriptorSets[PipelineType::RENDER][imageIndex], 0,
+                          nullptr);
+
+  vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                        COUNTER_TILE_ARGS * sizeof(uint32_t));
+
+  // Chunks of the split tiles, then their merge. Same layout, so the
+  // descriptor set and push constants above stay bound
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::RENDER_CHUNK]);
+  vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                        COUNTER_SPLIT_ARGS * sizeof(uint32_t));
+
+  InsertMemoryBarrier(commandBuffer);
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::RENDER_MERGE]);
+  vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                        COUNTER_TILE_ARGS * sizeof(uint32_t));
+
+  if (_timestampPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        _timestampPool, TIMESTAMPS_PER_IMAGE * imageIndex + 1);
+    _timestampPending[imageIndex] = true;
+    _timestampKernel[imageIndex] = rasterizer;
+  }
+}
+
+void ComputePipeline::RecordSortFreePath(VkCommandBuffer commandBuffer,
+                                         uint32_t imageIndex) {
+  // No keys, sort or tile lists: every visible Gaussian is drawn as a quad
+  // straight from the preprocess output and blended order independently
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+
+  _splatRasterPipeline.RecordWboitPass(commandBuffer,
+                                       ReadCounter(COUNTER_VISIBLE),
+                                       g_renderSettings.wboitDepthScale);
+  RecordSplatResolve(commandBuffer, imageIndex, false);
+}
+
+void ComputePipeline::RecordSortedQuadPath(VkCommandBuffer commandBuffer,
+                                           uint32_t imageIndex) {
+  // Global front-to-back order with the depth keys of the temporal order
+  // rebuild. Culled Gaussians get the largest key and sort to the back
+  uint32_t numElements = uint32_t(_numGaussians);
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::DEPTH_KEYS]);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::DEPTH_KEYS], 0, 1,
+      &_descriptorSets[PipelineType::DEPTH_KEYS][imageIndex], 0, nullptr);
+  vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::DEPTH_KEYS],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t),
+                     &numElements);
+  vkCmdDispatch(commandBuffer, (numElements + 255) / 256, 1, 1);
+  InsertMemoryBarrier(commandBuffer);
+
+  RecordRadixSort(commandBuffer, imageIndex, numElements, 0, 4);
+
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+
+  // The visible Gaussians are the front of the order. With temporal sort the
+  // visible count is every Gaussian and the culled tail is clipped
+  _splatRasterPipeline.RecordSortedPass(commandBuffer,
+                                        ReadCounter(COUNTER_VISIBLE));
+  RecordSplatResolve(commandBuffer, imageIndex, true);
+}
+
+void ComputePipeline::RecordSplatResolve(VkCommandBuffer commandBuffer,
+                                         uint32_t imageIndex,
+                                         bool sortedQuads) {
+  // The resolve writes every pixel, so the output needs no clear
+  struct {
+    uint32_t w;
+    uint32_t h;
+    uint32_t sortedQuads;
+  } pcResolve = {_renderExtent.width, _renderExtent.height,
+                 uint32_t(sortedQuads)};
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::WBOIT_RESOLVE]);
+  vkCmdPushConstants(commandBuffer,
+                     _pipelineLayouts[PipelineType::WBOIT_RESOLVE],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pcResolve),
+                     &pcResolve);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::WBOIT_RESOLVE], 0, 1,
+      &_descriptorSets[PipelineType::WBOIT_RESOLVE][imageIndex], 0, nullptr);
+  vkCmdDispatch(commandBuffer, (pcResolve.w + 15) / 16, (pcResolve.h + 15) / 16,
+                1);
+}
+
+void ComputePipeline::RecordOutputCapture(VkCommandBuffer commandBuffer,
+                                          uint32_t imageIndex, uint32_t slot) {
+  _captureExtent = _renderExtent;
+  VkDeviceSize sliceSize =
+      VkDeviceSize(_captureExtent.width) * _captureExtent.height * 4;
+  if (_captureBuffer == VK_NULL_HANDLE) {
+    // Sized for the native extent, the render extent only shrinks from it
+    VkExtent2D native = GetNativeExtent();
+    _captureBuffer = _buffManager->CreateBuffer(
+        _vkContext.GetLogicalDevice(), _vkContext.GetPhysicalDevice(),
+        NUM_CAPTURE_SLOTS * VkDeviceSize(native.width) * native.height * 4,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  }
+
+  VkImage output = _upsample
+                       ? _renderTarget.image
+                       : _vkContext.GetSwapchainImages()[imageIndex].image;
+
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_TRANSFER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  VkBufferImageCopy region = {};
+  region.bufferOffset = slot * sliceSize;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = {_captureExtent.width, _captureExtent.height, 1};
+  vkCmdCopyImageToBuffer(commandBuffer, output, VK_IMAGE_LAYOUT_GENERAL,
+                         _captureBuffer, 1, &region);
+
+  // The next path clears and rewrites the output
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_READ_BIT,
+                      VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT |
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+}
+
+float ComputePipeline::ComputeCapturePsnr(uint32_t slot, uint32_t reference,
+                                          int *maxError) {
+  VkDevice device = _vkContext.GetLogicalDevice();
+  VkDeviceMemory memory = _buffManager->GetBufferMemory(_captureBuffer);
+  size_t pixels = size_t(_captureExtent.width) * _captureExtent.height;
+
+  void *mapped;
+  vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+  const uint8_t *expected =
+      static_cast<const uint8_t *>(mapped) + 4 * pixels * reference;
+  const uint8_t *other =
+      static_cast<const uint8_t *>(mapped) + 4 * pixels * slot;
+
+  // Color channels only; RGBA and BGRA swapchains both keep alpha last
+  double sumSq = 0.0;
+  int maxDiff = 0;
+  for (size_t p = 0; p < pixels; p++) {
+    for (size_t c = 0; c < 3; c++) {
+      int d = int(expected[4 * p + c]) - int(other[4 * p + c]);
+      sumSq += double(d * d);
+      maxDiff = std::max(maxDiff, std::abs(d));
+    }
+  }
+  vkUnmapMemory(device, memory);
+  if (maxError) {
+    *maxError = maxDiff;
+  }
+
+  double mse = sumSq / double(3 * pixels);
+  if (mse == 0.0) {
+    return std::numeric_limits<float>::infinity();
+  }
+  return float(10.0 * std::log10(255.0 * 255.0 / mse));
+}
+
+// Name and value labels of every SettingCheck. Settings that must not change
+// the image give the bounds every value has to meet against the first one,
+// a maxError of -1 reports the error without a verdict
+static const struct {
+  const char *name;
+  int numValues;
+  const char *values[NUM_CAPTURE_SLOTS];
+  float minPsnr;
+  int maxError;
+} SETTING_CHECKS[] = {
+    {"", 0, {}, 0.0f, -1},
+    {"Exact tile intersection", 2, {"off", "on"}, 0.0f, -1},
+    // Only fragments under the 1/255 alpha cutoff are dropped
+    {"Opacity aware radius", 2, {"off", "on"}, 45.0f, 4},
+    // Same keys in the same order, only the thread mapping differs
+    {"Tile ID threads", 2, {"per Gaussian", "per key"}, 0.0f, 0},
+    // fp16 conic and color in the records
+    {"Packed splats", 2, {"unpacked", "packed"}, 0.0f, -1},
+    {"Covariance storage", NUM_COV_PRECISIONS, {"rebuilt", "fp32", "fp16"},
+     0.0f, -1},
+};
+
+int ComputePipeline::GetCheckedSetting(SettingCheck kind) {
+  switch (kind) {
+  case SettingCheck::ExactTiles:
+    return int(g_renderSettings.exactTileIntersection);
+  case SettingCheck::OpacityRadius:
+    return int(g_renderSettings.opacityAwareRadius);
+  case SettingCheck::TileIdThreads:
+    return int(g_renderSettings.tileIdPerKey);
+  case SettingCheck::PackedSplats:
+    return int(g_renderSettings.packedSplats);
+  case SettingCheck::CovStorage:
+    return g_renderSettings.covPrecision;
+  default:
+    return 0;
+  }
+}
+
+void ComputePipeline::SetCheckedSetting(SettingCheck kind, int value) {
+  switch (kind) {
+  case SettingCheck::ExactTiles:
+    g_renderSettings.exactTileIntersection = value != 0;
+    break;
+  case SettingCheck::OpacityRadius:
+    g_renderSettings.opacityAwareRadius = value != 0;
+    break;
+  case SettingCheck::TileIdThreads:
+    g_renderSettings.tileIdPerKey = value != 0;
+    break;
+  case SettingCheck::PackedSplats:
+    g_renderSettings.packedSplats = value != 0;
+    break;
+  case SettingCheck::CovStorage:
+    g_renderSettings.covPrecision = value;
+    break;
+  default:
+    break;
+  }
+}
+
+void ComputePipeline::UpdateSettingCheck(Camera &cam) {
+  SettingCheck requested = SettingCheck(g_renderSettings.settingCheck);
+  g_renderSettings.settingCheck = int(SettingCheck::None);
+  if (_check.kind == SettingCheck::None && requested != SettingCheck::None) {
+    _check = SettingCheckState();
+    _check.kind = requested;
+    _check.restore = GetCheckedSetting(requested);
+    _check.camPos = cam.GetPosition();
+    _check.camFront = cam.GetFront();
+    g_renderSettings.settingCheckRunning = true;
+  }
+  if (_check.kind != SettingCheck::None) {
+    SetCheckedSetting(_check.kind, _check.value);
+  }
+}
+
+void ComputePipeline::AdvanceSettingCheck(uint32_t imageIndex,
+                                          uint32_t numRendered, Camera &cam) {
+  if (cam.GetPosition() != _check.camPos ||
+      cam.GetFront() != _check.camFront) {
+    FinishSettingCheck("the camera moved");
+    return;
+  }
+  if (numRendered == 0) {
+    FinishSettingCheck("nothing is rendered");
+    return;
+  }
+
+  vkWaitForFences(_vkContext.GetLogicalDevice(), 1,
+                  &_renderFences[_currentFrame], VK_TRUE, UINT64_MAX);
+  ReadRenderTimestamps(imageIndex);
+  if (_check.frame >= CHECK_WARMUP_FRAMES) {
+    _check.numRendered[_check.value] += numRendered;
+    _check.preprocessMs[_check.value] += _preprocessMs;
+    _check.frontEndMs[_check.value] += _frontEndMs;
+    _check.renderMs[_check.value] += _renderMs;
+    _check.tileIdMs[_check.value] += g_renderSettings.tileIdTimeMs;
+    _check.rasterMs[_check.value] += g_renderSettings.rasterTimeMs;
+  }
+  if (++_check.frame < CHECK_WARMUP_FRAMES + CHECK_FRAMES) {
+    return;
+  }
+  _check.frame = 0;
+  if (++_check.value < SETTING_CHECKS[int(_check.kind)].numValues) {
+    return;
+  }
+  FinishSettingCheck("");
+}
+
+void ComputePipeline::FinishSettingCheck(const std::string &abortReason) {
+  const auto &info = SETTING_CHECKS[int(_check.kind)];
+  SetCheckedSetting(_check.kind, _check.restore);
+
+  // Means over the measured frames; the image error is of the last frame of
+  // each value against the first value's
+  std::ostringstream report;
+  report << info.name << " check";
+  if (!abortReason.empty()) {
+    report << " aborted, " << abortReason;
+  }
+  for (int value = 0; abortReason.empty() && value < info.numValues;
+       value++) {
+    double keys = _check.numRendered[value] / CHECK_FRAMES;
+    report << "\n  " << info.values[value] << ": " << uint64_t(keys)
+           << " keys";
+    if (value > 0 && _check.numRendered[0] > 0) {
+      double ratio = _check.numRendered[value] / _check.numRendered[0];
+      double change = 100.0 * (ratio - 1.0);
+      report << " (" << std::showpos << change << std::noshowpos << "%)";
+    }
+    report << ", preprocess " << _check.preprocessMs[value] / CHECK_FRAMES
+           << " ms, front end " << _check.frontEndMs[value] / CHECK_FRAMES
+           << " ms, tile IDs " << _check.tileIdMs[value] / CHECK_FRAMES
+           << " ms, raster " << _check.rasterMs[value] / CHECK_FRAMES
+           << " ms, render " << _check.renderMs[value] / CHECK_FRAMES
+           << " ms";
+    if (value > 0) {
+      int maxError = 0;
+      float psnr = ComputeCapturePsnr(value, 0, &maxError);
+      report << ", " << psnr << " dB, max error " << maxError << " / 255";
+      if (info.maxError >= 0) {
+        bool pass = psnr >= info.minPsnr && maxError <= info.maxError;
+        report << (pass ? ", PASS" : ", FAIL") << " (>= " << info.minPsnr
+               << " dB, <= " << info.maxError << ")";
+      }
+    }
+  }
+  std::cout << report.str() << std::endl;
+  g_renderSettings.settingCheckReport = report.str();
+  g_renderSettings.settingCheckRunning = false;
+  _check = SettingCheckState();
+}
+
+VkShaderModule
+ComputePipeline::CreateShaderModule(const std::vector<char> &code) {
+  VkShaderModuleCreateInfo shaderCreateInfo = {};
+  shaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  shaderCreateInfo.codeSize = code.size();
+  shaderCreateInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+
+  VkShaderModule shaderModule;
+  if (vkCreateShaderModule(_vkContext.GetLogicalDevice(), &shaderCreateInfo,
+                           nullptr, &shaderModule) != VK_SUCCESS)
+    throw std::runtime_error("Fail Creating Shader Module");
+
+  return shaderModule;
+}
+
+void ComputePipeline::TransitionImage(VkCommandBuffer commandBuffer,
+                                      VkImageLayout in, VkImageLayout out,
+                                      VkImage image, VkAccessFlags src,
+                                      VkAccessFlags dst,
+                                      VkPipelineStageFlagBits srcStage,
+                                      VkPipelineStageFlagBits dstStage) {
+
+  // Transition swapchain image to GENERAL layout for compute write
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER; // Type of barrier
+  barrier.oldLayout = in;  // Don't care about previous contents
+  barrier.newLayout = out; // Layout for compute shader access
+  barrier.srcQueueFamilyIndex =
+      VK_QUEUE_FAMILY_IGNORED; // Not transferring between queue families
+  barrier.dstQueueFamilyIndex =
+      VK_QUEUE_FAMILY_IGNORED; // Not transferring between queue families
+  barrier.image = image;       // The specific swapchain image
+  barrier.subresourceRange.aspectMask =
+      VK_IMAGE_ASPECT_COLOR_BIT;               // Color data (not depth/stencil)
+  barrier.subresourceRange.baseMipLevel = 0;   // Mipmap level 0
+  barrier.subresourceRange.levelCount = 1;     // Only 1 mipmap level
+  barrier.subresourceRange.baseArrayLayer = 0; // Array layer 0
+  barrier.subresourceRange.layerCount = 1;     // Only 1 array layer
+  barrier.srcAccessMask = src;                 // No previous access to wait for
+  barrier.dstAccessMask = dst;                 // Compute shader will write
+
+  vkCmdPipelineBarrier(
+      commandBuffer, // Command buffer to record into
+      srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1,
+      &barrier); // 1 image barrier, no memory/buffer barriers //
+}
+
+void ComputePipeline::RenderFrame(Camera &cam, bool cacheFrame) {
+  UpdateSettingCheck(cam);
+  ApplyTileSize();
+  ApplyCovPrecision();
+  ApplyUpsampling();
+
+  vkWaitForFences(_vkContext.GetLogicalDevice(), 1,
+                  &_renderFences[_currentFrame], VK_TRUE, UINT64_MAX);
+
+  vkResetFences(_vkContext.GetLogicalDevice(), 1,
+                &_preprocessFences[_currentFrame]);
+
+  uint32_t imageIndex;
+  VkResult result = vkAcquireNextImageKHR(
+      _vkContext.GetLogicalDevice(), _vkContext.GetSwapchain(), UINT64_MAX,
+      _semaphores[_currentFrame], VK_NULL_HANDLE, &imageIndex);
+
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("Failed to acquire swapchain image!");
+  }
+
+  vkResetCommandBuffer(_commandBuffers[imageIndex], 0);
+  vkResetCommandBuffer(_renderCommandBuffers[imageIndex], 0);
+  UpdateOcclusionState(cam);
+  _shLodReport = g_renderSettings.shLodReportRequested;
+  g_renderSettings.shLodReportRequested = false;
+  RecordCommandPreprocess(imageIndex);
+  submitCommandBuffer(imageIndex);
+
+  vkWaitForFences(_vkContext.GetLogicalDevice(), 1,
+                  &_preprocessFences[_currentFrame], VK_TRUE, UINT64_MAX);
+
+  ReadPreprocessTimestamps(imageIndex);
+  uint32_t totalRendered = ReadFinalPrefixSum();
+  g_renderSettings.numRendered = totalRendered;
+  // The temporal order presets COUNTER_VISIBLE to every Gaussian
+  g_renderSettings.numVisible =
+      ReadCounter(_temporalSort ? COUNTER_SPLATS_KEPT : COUNTER_VISIBLE);
+  g_renderSettings.numOccluded = ReadCounter(COUNTER_OCCLUDED);
+  g_renderSettings.numShEvals = ReadCounter(COUNTER_SH_EVALS);
+  g_renderSettings.numShFetches = ReadCounter(COUNTER_SH_FETCHES);
+  g_renderSettings.numShReduced = ReadCounter(COUNTER_SH_REDUCED);
+  g_renderSettings.numClusters = _numClusters;
+  g_renderSettings.numBudgetDropped = ReadCounter(COUNTER_BUDGET_DROPPED);
+  g_renderSettings.numVisibleClusters =
+      _clusterCull ? ReadCounter(COUNTER_CLUSTER_ARGS) : _numClusters;
+  if (_shLodReport) {
+    uint32_t reduced = g_renderSettings.numShReduced;
+    uint32_t errorSum = ReadCounter(COUNTER_SH_LOD_ERROR);
+    g_renderSettings.shLodError =
+        reduced > 0 ? float(errorSum) / reduced : 0.0f;
+    std::cout << "SH LOD: " << reduced << " of "
+              << g_renderSettings.numShEvals
+              << " evaluations reduced, mean error "
+              << g_renderSettings.shLodError << " / 255" << std::endl;
+  }
+
+  // Too much disorder left after the repair passes: sort this frame from
+  // scratch and rebuild the temporal order on the next one
+  bool fullSort = true;
+  if (_temporalSort) {
+    uint32_t inversions = ReadCounter(COUNTER_SORT_INVERSIONS);
+    fullSort = inversions > uint32_t(g_renderSettings.sortMaxDisorder *
+                                     float(_numGaussians));
+    _rebuildSortOrder = _rebuildSortOrder || fullSort;
+    g_renderSettings.sortInversions = inversions;
+  }
+  g_renderSettings.fullSort = fullSort;
+
+  // Latched here, the UI may change the setting while the frame is recorded.
+  // A setting check measures the sorted path and owns the capture buffer
+  bool checking = _check.kind != SettingCheck::None;
+  RenderMode mode =
+      checking ? RenderMode::Sorted : RenderMode(g_renderSettings.renderMode);
+  bool compare = g_renderSettings.compareRequested && totalRendered > 0 &&
+                 !checking;
+  g_renderSettings.compareRequested =
+      g_renderSettings.compareRequested && checking;
+  int captureSlot =
+      checking && _check.frame == CHECK_WARMUP_FRAMES + CHECK_FRAMES - 1
+          ? _check.value
+          : -1;
+
+  // The temporal order and the sorted quad path sort every Gaussian
+  uint32_t required = totalRendered;
+  if (_temporalSort || mode == RenderMode::SortedQuads || compare) {
+    required = std::max(required, uint32_t(_numGaussians));
+  }
+  if (required > _sizeBufferMax) {
+    resizeBuffers(required * 1.25f);
+  }
+
+  vkResetFences(_vkContext.GetLogicalDevice(), 1,
+                &_renderFences[_currentFrame]);
+
+  RecordCommandRender(imageIndex, totalRendered, cam, fullSort, mode, compare,
+                      cacheFrame, captureSlot);
+  submitCommandBuffer(imageIndex, false);
+
+  if (compare) {
+    vkWaitForFences(_vkContext.GetLogicalDevice(), 1,
+                    &_renderFences[_currentFrame], VK_TRUE, UINT64_MAX);
+    ReadRenderTimestamps(imageIndex);
+    const float *timeMs = g_renderSettings.pathTimeMs;
+    for (int other = 0; other < NUM_RENDER_MODES; other++) {
+      if (other == int(RenderMode::Sorted)) {
+        continue;
+      }
+      g_renderSettings.comparePsnr[other] =
+          ComputeCapturePsnr(other, uint32_t(RenderMode::Sorted));
+      std::cout << "Render path " << other << " vs sorted: PSNR "
+                << g_renderSettings.comparePsnr[other] << " dB, "
+                << timeMs[other] << " ms vs "
+                << timeMs[int(RenderMode::Sorted)] << " ms" << std::endl;
+    }
+  }
+
+  // Only the sorted path writes tileDepth, and nothing was rasterized
+  // without splats
+  _occlusionHistory.valid =
+      totalRendered > 0 && (mode == RenderMode::Sorted || compare);
+  _occlusionHistory.camPos = cam.GetPosition();
+  _occlusionHistory.fov = g_renderSettings.fov;
+  _occlusionHistory.tileSpec = _tileSpec;
+  _occlusionHistory.tileGrid = GetTileGrid();
+
+  if (checking) {
+    AdvanceSettingCheck(imageIndex, totalRendered, cam);
+  } else {
+    // Takes effect on the next frame, whose camera uniforms are written
+    // before it is recorded. Held during a check so every capture has the
+    // same extent
+    UpdateRenderScale();
+  }
+  PresentImage(imageIndex);
+}
+
+void ComputePipeline::PresentCachedFrame(Camera &cam) {
+  VkDevice device = _vkContext.GetLogicalDevice();
+  vkWaitForFences(device, 1, &_renderFences[_currentFrame], VK_TRUE,
+                  UINT64_MAX);
+
+  uint32_t imageIndex;
+  if (vkAcquireNextImageKHR(device, _vkContext.GetSwapchain(), UINT64_MAX,
+                            _semaphores[_currentFrame], VK_NULL_HANDLE,
+                            &imageIndex) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to acquire swapchain image!");
+  }
+
+  VkCommandBuffer commandBuffer = _renderCommandBuffers[imageIndex];
+  vkResetCommandBuffer(commandBuffer, 0);
+  VkCommandBufferBeginInfo beginInfo = {};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to begin recording command buffer!");
+  }
+
+  // A copy instead of preprocess, sort and render
+  VkImage swapchainImage = _vkContext.GetSwapchainImages()[imageIndex].image;
+  TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED,
+                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, swapchainImage,
+                  VK_ACCESS_NONE, VK_ACCESS_TRANSFER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT);
+  VkExtent2D extent = _vkContext.GetSwapchainExtent();
+  VkImageCopy region = {};
+  region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.dstSubresource = region.srcSubresource;
+  region.extent = {extent.width, extent.height, 1};
+  vkCmdCopyImage(commandBuffer, _frameCache.image,
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapchainImage,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  TransitionImage(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                  VK_IMAGE_LAYOUT_GENERAL, swapchainImage,
+                  VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+  RecordOverlays(commandBuffer, imageIndex, cam);
+
+  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to record command buffer!");
+  }
+
+  vkResetFences(device, 1, &_renderFences[_currentFrame]);
+  VkSemaphore waitSemaphores[] = {_semaphores[_currentFrame]};
+  VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT};
+  VkSubmitInfo submitInfo = {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.waitSemaphoreCount = 1;
+  submitInfo.pWaitSemaphores = waitSemaphores;
+  submitInfo.pWaitDstStageMask = waitStages;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &commandBuffer;
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores = &_renderSemaphores[imageIndex];
+  if (vkQueueSubmit(_vkContext.GetGraphicsQueue(), 1, &submitInfo,
+                    _renderFences[_currentFrame]) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to submit cached frame!");
+  }
+
+  PresentImage(imageIndex);
+}
+
+void ComputePipeline::PresentImage(uint32_t imageIndex) {
+  VkPresentInfoKHR presentInfo = {};
+  presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+  VkSemaphore waitSemaphores[] = {_renderSemaphores[imageIndex]};
+  presentInfo.waitSemaphoreCount = 1;
+  presentInfo.pWaitSemaphores = waitSemaphores;
+  presentInfo.swapchainCount = 1;
+  VkSwapchainKHR swapchains[] = {_vkContext.GetSwapchain()};
+  presentInfo.pSwapchains = swapchains;
+  presentInfo.pImageIndices = &imageIndex;
 
   vkQueuePresentKHR(_vkContext.GetGraphicsQueue(), &presentInfo);
   _currentFrame = (_currentFrame + 1) % _renderFences.size();
@@ -884,10 +1837,13 @@ void ComputePipeline::UpdateAllDescriptorSets(const PipelineType pType) {
       if (descriptor.type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE) {
         VkImageView imageView = swapchainImages[i].imageView;
 
-#ifdef __APPLE__
-        if (pType == PipelineType::RENDER)
+        if (_upsample && (pType == PipelineType::RENDER ||
+                          pType == PipelineType::WBOIT_RESOLVE))
           imageView = _renderTarget.view;
-#endif
+        if (descriptor.name == "wboitAccum")
+          imageView = _splatRasterPipeline.GetAccumView();
+        else if (descriptor.name == "wboitReveal")
+          imageView = _splatRasterPipeline.GetRevealView();
 
         BindImageToDescriptor(pType, i, imageView, descriptor.binding);
 
@@ -913,6 +1869,12 @@ VkBuffer ComputePipeline::GetBufferByName(const std::string &bufferName) {
     return _gaussianBuffers.rotations;
   if (bufferName == "opacity")
     return _gaussianBuffers.opacity;
+  if (bufferName == "shBand1")
+    return _gaussianBuffers.shBand1;
+  if (bufferName == "shBand2")
+    return _gaussianBuffers.shBand2;
+  if (bufferName == "shBand3")
+    return _gaussianBuffers.shBand3;
   if (bufferName == "sh")
     return _gaussianBuffers.sh;
   if (bufferName == "camUniform")
@@ -947,6 +1909,40 @@ VkBuffer ComputePipeline::GetBufferByName(const std::string &bufferName) {
     return _resultBufferPrefix;
   if (bufferName == "histograms")
     return _gaussianBuffers.histogram;
+  if (bufferName == "sortOrder")
+    return _gaussianBuffers.sortOrder;
+  if (bufferName == "counters")
+    return _gaussianBuffers.counters;
+  if (bufferName == "visibleList")
+    return _gaussianBuffers.visibleList;
+  if (bufferName == "records")
+    return _gaussianBuffers.records;
+  if (bufferName == "tileSplit")
+    return _gaussianBuffers.tileSplit;
+  if (bufferName == "tileWork")
+    return _gaussianBuffers.tileWork;
+  if (bufferName == "partials")
+    return _gaussianBuffers.partials;
+  if (bufferName == "partialDepths")
+    return _gaussianBuffers.partialDepths;
+  if (bufferName == "activeTiles")
+    return _gaussianBuffers.activeTiles;
+  if (bufferName == "tileDepth")
+    return _gaussianBuffers.tileDepth;
+  if (bufferName == "cov3D")
+    return _gaussianBuffers.cov3D;
+  if (bufferName == "budgetHistogram")
+    return _gaussianBuffers.budgetHistogram;
+  if (bufferName == "clusterBounds")
+    return _gaussianBuffers.clusterBounds;
+  if (bufferName == "visibleClusters")
+    return _gaussianBuffers.visibleClusters;
+  if (bufferName == "colorCache")
+    return _gaussianBuffers.colorCache;
+  if (bufferName == "rowSpans")
+    return _gaussianBuffers.rowSpans;
+  if (bufferName == "rowTables")
+    return _gaussianBuffers.rowTables;
 
   throw std::runtime_error("Unknown buffer name: " + bufferName);
 }
@@ -986,9 +1982,651 @@ void ComputePipeline::submitCommandBuffer(uint32_t imageIndex, bool waitSem) {
   }
 }
 
-int ComputePipeline::getRadixIterations() {
+void ComputePipeline::RecordRadixSort(VkCommandBuffer commandBuffer,
+                                      uint32_t imageIndex,
+                                      uint32_t numElements, uint32_t firstShift,
+                                      uint32_t numPasses) {
+  uint32_t elementsPerWorkgroup =
+      WORKGROUP_SIZE * blocks_per_workgroup; // 256 * 32 = 8192
+  uint32_t numWorkgroups =
+      (numElements + elementsPerWorkgroup - 1) / elementsPerWorkgroup;
+
+  struct RadixPushConstants {
+    uint32_t g_num_elements;
+    uint32_t g_shift;
+    uint32_t g_num_workgroups;
+    uint32_t g_num_blocks_per_workgroup;
+  } radixPC;
+
+  radixPC.g_num_elements = numElements;
+  radixPC.g_num_workgroups = numWorkgroups;
+  radixPC.g_num_blocks_per_workgroup = blocks_per_workgroup;
+
+  // 8 bits per pass, ping-ponging between keys and keysRadix. numPasses has to
+  // be even so the sorted result ends up back in keys/values
+  for (uint32_t pass = 0; pass < numPasses; pass++) {
+    radixPC.g_shift = firstShift + pass * 8;
+
+    bool isEven = (pass % 2 == 0);
+
+    // HISTOGRAM PASS
+    PipelineType histType = isEven ? PipelineType::RADIX_HISTOGRAM_0
+                                   : PipelineType::RADIX_HISTOGRAM_1;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      _computePipelines[PipelineType::RADIX_HISTOGRAM_0]);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            _pipelineLayouts[PipelineType::RADIX_HISTOGRAM_0],
+                            0, 1, &_descriptorSets[histType][imageIndex], 0,
+                            nullptr);
+    vkCmdPushConstants(
+        commandBuffer, _pipelineLayouts[PipelineType::RADIX_HISTOGRAM_0],
+        VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RadixPushConstants), &radixPC);
+    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+
+    InsertMemoryBarrier(commandBuffer);
+
+    // SCATTER PASS
+    PipelineType scatterType = isEven ? PipelineType::RADIX_SCATTER_0
+                                      : PipelineType::RADIX_SCATTER_1;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      _computePipelines[PipelineType::RADIX_SCATTER_0]);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            _pipelineLayouts[PipelineType::RADIX_SCATTER_0], 0,
+                            1, &_descriptorSets[scatterType][imageIndex], 0,
+                            nullptr);
+    vkCmdPushConstants(
+        commandBuffer, _pipelineLayouts[PipelineType::RADIX_SCATTER_0],
+        VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RadixPushConstants), &radixPC);
+    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+
+    if (pass < numPasses - 1) {
+      InsertMemoryBarrier(commandBuffer);
+    }
+  }
+}
+
+void ComputePipeline::RecordSortOrderUpdate(VkCommandBuffer commandBuffer,
+                                            uint32_t imageIndex) {
+  uint32_t numElements = uint32_t(_numGaussians);
+  uint32_t groups = (numElements + 255) / 256;
+
+  bool rebuilt = _rebuildSortOrder;
+  if (rebuilt) {
+    // Full rebuild: radix sort all Gaussians by depth, keep the payload
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      _computePipelines[PipelineType::DEPTH_KEYS]);
+    vkCmdBindDescriptorSets(
+        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        _pipelineLayouts[PipelineType::DEPTH_KEYS], 0, 1,
+        &_descriptorSets[PipelineType::DEPTH_KEYS][imageIndex], 0, nullptr);
+    vkCmdPushConstants(commandBuffer,
+                       _pipelineLayouts[PipelineType::DEPTH_KEYS],
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t),
+                       &numElements);
+    vkCmdDispatch(commandBuffer, groups, 1, 1);
+    InsertMemoryBarrier(commandBuffer);
+
+    RecordRadixSort(commandBuffer, imageIndex, numElements, 0, 4);
+
+    InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                        VK_ACCESS_TRANSFER_READ_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT);
+    VkBufferCopy orderCopy = {};
+    orderCopy.size = sizeof(uint32_t) * numElements;
+    vkCmdCopyBuffer(commandBuffer, _gaussianBuffers.values,
+                    _gaussianBuffers.sortOrder, 1, &orderCopy);
+    InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    _rebuildSortOrder = false;
+  }
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::SORT_REPAIR]);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::SORT_REPAIR], 0, 1,
+      &_descriptorSets[PipelineType::SORT_REPAIR][imageIndex], 0, nullptr);
+
+  struct {
+    uint32_t numElements;
+    uint32_t mode;
+  } pushRepair = {numElements, 0};
+
+  // Odd-even transposition passes over last frame's order
+  if (!rebuilt) {
+    uint32_t pairGroups = (numElements / 2 + 255) / 256;
+    for (int pass = 0; pass < g_renderSettings.sortRepairPasses; pass++) {
+      for (uint32_t phase = 0; phase < 2; phase++) {
+        pushRepair.mode = phase;
+        vkCmdPushConstants(commandBuffer,
+                           _pipelineLayouts[PipelineType::SORT_REPAIR],
+                           VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushRepair),
+                           &pushRepair);
+        vkCmdDispatch(commandBuffer, pairGroups, 1, 1);
+        InsertMemoryBarrier(commandBuffer,
+                            VK_ACCESS_SHADER_WRITE_BIT,
+                            VK_ACCESS_SHADER_READ_BIT |
+                                VK_ACCESS_SHADER_WRITE_BIT);
+      }
+    }
+  }
+
+  // Gather tilesTouched into sorted order (into the prefix sum's B buffer)
+  // and count the inversions that are left
+  pushRepair.mode = 2;
+  vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::SORT_REPAIR],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushRepair),
+                     &pushRepair);
+  vkCmdDispatch(commandBuffer, groups, 1, 1);
+
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_TRANSFER_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  VkBufferCopy tilesCopy = {};
+  tilesCopy.size = sizeof(uint32_t) * numElements;
+  vkCmdCopyBuffer(commandBuffer, _gaussianBuffers.tilesTouchedPrefixSum,
+                  _gaussianBuffers.tilesTouched, 1, &tilesCopy);
+
+  // Key generation walks the Gaussians through the visible list
+  vkCmdCopyBuffer(commandBuffer, _gaussianBuffers.sortOrder,
+                  _gaussianBuffers.visibleList, 1, &tilesCopy);
+
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+}
+
+void ComputePipeline::InsertMemoryBarrier(VkCommandBuffer commandBuffer,
+                                          VkAccessFlags src, VkAccessFlags dst,
+                                          VkPipelineStageFlags srcStage,
+                                          VkPipelineStageFlags dstStage) {
+  VkMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = src;
+  barrier.dstAccessMask = dst;
+  vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &barrier, 0,
+                       nullptr, 0, nullptr);
+}
+
+uint32_t ComputePipeline::GetTileSortPasses() {
+  VkExtent2D tileGrid = GetTileGrid();
+  uint32_t nTiles = tileGrid.width * tileGrid.height;
+  uint32_t tileBits = 1;
+  while ((1u << tileBits) < nTiles) {
+    tileBits++;
+  }
+  uint32_t passes = (tileBits + 7) / 8;
+  return passes + (passes % 2);
+}
+
+VkExtent2D ComputePipeline::GetTileGrid() {
+  return {(_renderExtent.width + _tileSpec.width - 1) / _tileSpec.width,
+          (_renderExtent.height + _tileSpec.height - 1) / _tileSpec.height};
+}
+
+VkExtent2D ComputePipeline::GetNativeExtent() {
   VkExtent2D extent = _vkContext.GetSwapchainExtent();
-  uint32_t nTiles = ((extent.width + 15) / 16) * ((extent.height + 15) / 16);
+  return {extent.width / _windowResize, extent.height / _windowResize};
+}
+
+void ComputePipeline::SetRenderScale(float scale) {
+  // Steps of 1/32 keep the controller's small corrections from moving the
+  // tile grid, and with it the occlusion history, every frame
+  float step = std::round(std::clamp(scale, 0.25f, 1.0f) * 32.0f) / 32.0f;
+  VkExtent2D native = GetNativeExtent();
+  _renderExtent = {std::max(1u, uint32_t(float(native.width) * step)),
+                   std::max(1u, uint32_t(float(native.height) * step))};
+  _splatRasterPipeline.SetRenderExtent(_renderExtent);
+  g_renderSettings.renderWidth = int(_renderExtent.width);
+  g_renderSettings.renderHeight = int(_renderExtent.height);
+}
+
+bool ComputePipeline::UpsampleNeeded() {
+  // Dynamic resolution keeps upsampling at full scale, so the controller does
+  // not rebind the output every time it reaches 1
+  VkExtent2D native = GetNativeExtent();
+  return _windowResize > 1 || g_renderSettings.dynamicResolution ||
+         _renderExtent.width != native.width ||
+         _renderExtent.height != native.height;
+}
+
+void ComputePipeline::ApplyUpsampling() {
+  bool upsample = UpsampleNeeded();
+  if (upsample == _upsample) {
+    return;
+  }
+
+  // The output image is baked into the descriptor sets
+  vkDeviceWaitIdle(_vkContext.GetLogicalDevice());
+  _upsample = upsample;
+  UpdateAllDescriptorSets(PipelineType::RENDER);
+  UpdateAllDescriptorSets(PipelineType::WBOIT_RESOLVE);
+}
+
+void ComputePipeline::UpdateRenderScale() {
+  float &scale = g_renderSettings.renderScale;
+  float gpuMs = _frontEndMs + _renderMs;
+  g_renderSettings.gpuFrameMs = gpuMs;
+
+  // Velocity form PID on the relative frame time error, positive while there
+  // is headroom. It adjusts the scale instead of setting it, so nothing winds
+  // up while the scale sits at a limit. Without GPU timestamps the scale
+  // stays where it is
+  if (g_renderSettings.dynamicResolution && gpuMs > 0.0f) {
+    float target = std::max(g_renderSettings.targetFrameMs, 1.0f);
+    float error = (target - gpuMs) / target;
+    scale += g_renderSettings.resolutionKp * (error - _scaleError[0]) +
+             g_renderSettings.resolutionKi * error +
+             g_renderSettings.resolutionKd *
+                 (error - 2.0f * _scaleError[0] + _scaleError[1]);
+    _scaleError[1] = _scaleError[0];
+    _scaleError[0] = error;
+    scale = std::clamp(scale, g_renderSettings.minRenderScale, 1.0f);
+  } else {
+    _scaleError[0] = _scaleError[1] = 0.0f;
+  }
+  SetRenderScale(scale);
+}
+
+TileSpecialization ComputePipeline::TileSpecFor(TileSize size) {
+  switch (size) {
+  case TileSize::Tile8x8:
+    return {8, 8, 4, 4};
+  case TileSize::Tile32x16:
+    return {32, 16, 16, 8};
+  case TileSize::Tile32x32:
+    return {32, 32, 16, 16};
+  default:
+    return {16, 16, 8, 8};
+  }
+}
+
+bool ComputePipeline::TileSizeSupported(const TileSpecialization &spec) {
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(_vkContext.GetPhysicalDevice(), &properties);
+  const VkPhysicalDeviceLimits &limits = properties.limits;
+
+  // One invocation per pixel in render and render_shared_mem; the latter
+  // also keeps xy, conic/opacity, color (padded), coverage and a flag per
+  // invocation
+  uint32_t invocations = spec.width * spec.height;
+  uint32_t sharedBytes = invocations * (2 + 4 + 4 + 1 + 1) * sizeof(float);
+
+  // The rasterizers get one workgroup per non-empty tile along x, at most
+  // the native extent's
+  VkExtent2D extent = GetNativeExtent();
+  uint32_t numTiles = ((extent.width + spec.width - 1) / spec.width) *
+                      ((extent.height + spec.height - 1) / spec.height);
+  return numTiles <= limits.maxComputeWorkGroupCount[0] &&
+         spec.width <= limits.maxComputeWorkGroupSize[0] &&
+         spec.height <= limits.maxComputeWorkGroupSize[1] &&
+         invocations <= limits.maxComputeWorkGroupInvocations &&
+         sharedBytes <= limits.maxComputeSharedMemorySize;
+}
+
+void ComputePipeline::ApplyTileSize() {
+  if (g_renderSettings.tileSize == _activeTileSize) {
+    return;
+  }
+
+  TileSpecialization spec = TileSpecFor(TileSize(g_renderSettings.tileSize));
+  if (!TileSizeSupported(spec)) {
+    std::cout << "Tile size " << spec.width << "x" << spec.height
+              << " exceeds the device compute limits, keeping "
+              << _tileSpec.width << "x" << _tileSpec.height << std::endl;
+    g_renderSettings.tileSize = _activeTileSize;
+    return;
+  }
+
+  // Specialization constants are baked at pipeline creation, so every
+  // tile-dependent pipeline is rebuilt once nothing is in flight
+  VkDevice device = _vkContext.GetLogicalDevice();
+  vkDeviceWaitIdle(device);
+  _tileSpec = spec;
+  for (const auto &[pType, shader] : _tileShaders) {
+    // The alternative kernels share the layout of the one they stand in for
+    PipelineType layout =
+        _pipelineLayouts.count(pType) ? pType : PipelineType::RENDER;
+    if (pType == PipelineType::ASSIGN_TILE_IDS_GAUSSIAN) {
+      layout = PipelineType::ASSIGN_TILE_IDS;
+    }
+    uint32_t subgroupInvocations =
+        pType == PipelineType::RENDER_SHARED ? spec.width * spec.height : 0;
+    vkDestroyPipeline(device, _computePipelines[pType], nullptr);
+    _computePipelines[pType] =
+        BuildComputePipeline(g_renderSettings.shaderPath + "Shaders/" + shader,
+                             _pipelineLayouts[layout], subgroupInvocations);
+  }
+  _activeTileSize = g_renderSettings.tileSize;
+
+  // Kernel timings do not carry over to another tile size
+  _lastRasterizer = -1;
+  std::cout << "Tile size set to " << spec.width << "x" << spec.height
+            << std::endl;
+}
+
+void ComputePipeline::ApplyCovPrecision() {
+  CovPrecision precision = CovPrecision(g_renderSettings.covPrecision);
+  if (_gaussianBuffers.cov3D != VK_NULL_HANDLE && precision == _covPrecision) {
+    return;
+  }
+
+  // Six fp32, or an fp32 scale and six normalized fp16 in three uints.
+  // Without precomputation a minimal buffer keeps the descriptor valid
+  VkDeviceSize bytesPerGaussian = 0;
+  if (precision == CovPrecision::Fp32) {
+    bytesPerGaussian = 6 * sizeof(float);
+  } else if (precision == CovPrecision::Fp16) {
+    bytesPerGaussian = 4 * sizeof(uint32_t);
+  }
+  VkDeviceSize size = std::max<VkDeviceSize>(
+      bytesPerGaussian * uint32_t(_numGaussians), sizeof(uint32_t));
+
+  VkDevice device = _vkContext.GetLogicalDevice();
+  if (_gaussianBuffers.cov3D != VK_NULL_HANDLE) {
+    vkDeviceWaitIdle(device);
+    _buffManager->DestroyBuffer(device, _gaussianBuffers.cov3D);
+  }
+  _gaussianBuffers.cov3D = _buffManager->CreateBuffer(
+      device, _vkContext.GetPhysicalDevice(), size,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _covPrecision = precision;
+  _cov3DDirty = precision != CovPrecision::None;
+
+  // Initialize creates the buffer before the descriptor sets exist
+  if (_descriptorSets.count(PipelineType::COV3D)) {
+    UpdateAllDescriptorSets(PipelineType::PREPROCESS);
+    UpdateAllDescriptorSets(PipelineType::COV3D);
+  }
+  std::cout << "3D covariance storage: " << size << " bytes" << std::endl;
+}
+
+void ComputePipeline::RecordCov3DBuild(VkCommandBuffer commandBuffer,
+                                       uint32_t imageIndex) {
+  // Scale and rotation never change, so this runs once per precision
+  struct {
+    uint32_t numGaussians;
+    uint32_t covPrecision;
+  } pushCov = {uint32_t(_numGaussians), uint32_t(_covPrecision)};
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::COV3D]);
+  vkCmdPushConstants(commandBuffer, _pipelineLayouts[PipelineType::COV3D],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushCov),
+                     &pushCov);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::COV3D], 0, 1,
+      &_descriptorSets[PipelineType::COV3D][imageIndex], 0, nullptr);
+  vkCmdDispatch(commandBuffer, (pushCov.numGaussians + 255) / 256, 1, 1);
+  InsertMemoryBarrier(commandBuffer);
+  _cov3DDirty = false;
+}
+
+void ComputePipeline::RecordClusterCull(VkCommandBuffer commandBuffer,
+                                        uint32_t imageIndex) {
+  struct {
+    uint32_t numClusters;
+    float nearPlane;
+    float farPlane;
+  } pushCull = {_numClusters, g_renderSettings.nearPlane,
+                g_renderSettings.farPlane};
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::CLUSTER_CULL]);
+  vkCmdPushConstants(commandBuffer,
+                     _pipelineLayouts[PipelineType::CLUSTER_CULL],
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushCull),
+                     &pushCull);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::CLUSTER_CULL], 0, 1,
+      &_descriptorSets[PipelineType::CLUSTER_CULL][imageIndex], 0, nullptr);
+  vkCmdDispatch(commandBuffer, (_numClusters + 255) / 256, 1, 1);
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT |
+                          VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                          VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+}
+
+void ComputePipeline::RecordSplatBudget(VkCommandBuffer commandBuffer,
+                                        uint32_t imageIndex) {
+  vkCmdFillBuffer(commandBuffer, _gaussianBuffers.budgetHistogram, 0,
+                  VK_WHOLE_SIZE, 0);
+  InsertMemoryBarrier(commandBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    _computePipelines[PipelineType::SPLAT_BUDGET]);
+  vkCmdBindDescriptorSets(
+      commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      _pipelineLayouts[PipelineType::SPLAT_BUDGET], 0, 1,
+      &_descriptorSets[PipelineType::SPLAT_BUDGET][imageIndex], 0, nullptr);
+
+  // Histogram and filter run over the visible list like the prefix sum, the
+  // threshold pass is a single workgroup over the bins
+  uint32_t budget = uint32_t(std::max(g_renderSettings.splatBudgetCount, 1));
+  for (uint32_t pass = 0; pass < 3; pass++) {
+    struct {
+      uint32_t pass;
+      uint32_t budget;
+      uint32_t compact;
+      uint32_t weightByTiles;
+    } pushBudget = {pass, budget, uint32_t(!_temporalSort),
+                    uint32_t(g_renderSettings.budgetInstances)};
+    vkCmdPushConstants(commandBuffer,
+                       _pipelineLayouts[PipelineType::SPLAT_BUDGET],
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushBudget),
+                       &pushBudget);
+    if (pass == 1) {
+      vkCmdDispatch(commandBuffer, 1, 1, 1);
+    } else {
+      vkCmdDispatchIndirect(commandBuffer, _gaussianBuffers.counters,
+                            COUNTER_PREFIX_ARGS * sizeof(uint32_t));
+    }
+    InsertMemoryBarrier(commandBuffer,
+                        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+  }
+}
+
+void ComputePipeline::ReadPreprocessTimestamps(uint32_t imageIndex) {
+  if (_timestampPool == VK_NULL_HANDLE) {
+    return;
+  }
+
+  uint64_t ticks[4];
+  if (vkGetQueryPoolResults(_vkContext.GetLogicalDevice(), _timestampPool,
+                            _preprocessQueryBase + 4 * imageIndex, 4,
+                            sizeof(ticks), ticks, sizeof(uint64_t),
+                            VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+    return;
+  }
+  _frontEndMs = float(double(ticks[3] - ticks[2]) * _timestampPeriod * 1e-6);
+
+  // Moving average per covariance storage, for the side by side report
+  float ms = float(double(ticks[1] - ticks[0]) * _timestampPeriod * 1e-6);
+  _preprocessMs = ms;
+  float &avg = g_renderSettings.preprocessTimeMs[int(_covPrecision)];
+  avg = avg == 0.0f ? ms : 0.9f * avg + 0.1f * ms;
+}
+
+void ComputePipeline::UpdateOcclusionState(Camera &cam) {
+  // Rotation alone reprojects exactly. Translation adds parallax between
+  // occluder and occludee, covered by a one tile margin for small steps;
+  // faster motion falls back to no occlusion culling for the frame
+  float moved = glm::length(cam.GetPosition() - _occlusionHistory.camPos);
+  _occlusionActive =
+      g_renderSettings.occlusionCulling && _occlusionHistory.valid &&
+      moved <= g_renderSettings.occlusionMaxMove &&
+      _occlusionHistory.fov == g_renderSettings.fov &&
+      _occlusionHistory.tileSpec.width == _tileSpec.width &&
+      _occlusionHistory.tileSpec.height == _tileSpec.height &&
+      _occlusionHistory.tileGrid.width == GetTileGrid().width &&
+      _occlusionHistory.tileGrid.height == GetTileGrid().height;
+  _occlusionMargin =
+      moved > 0.0f ? float(std::max(_tileSpec.width, _tileSpec.height)) : 0.0f;
+}
+
+void ComputePipeline::CreateTimestampQueries() {
+  VkPhysicalDevice physicalDevice = _vkContext.GetPhysicalDevice();
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount,
+                                           nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount,
+                                           families.data());
+
+  uint32_t family = _vkContext.GetGraphicsFamily();
+  if (properties.limits.timestampPeriod == 0.0f ||
+      families[family].timestampValidBits == 0) {
+    std::cout << "GPU timestamps not supported, Auto rasterizer falls back to "
+                 "per-pixel"
+              << std::endl;
+    return;
+  }
+  _timestampPeriod = properties.limits.timestampPeriod;
+
+  size_t images = _vkContext.GetSwapchainImages().size();
+
+  VkQueryPoolCreateInfo queryInfo = {};
+  queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  queryInfo.queryCount = uint32_t((TIMESTAMPS_PER_IMAGE + 4) * images);
+
+  if (vkCreateQueryPool(_vkContext.GetLogicalDevice(), &queryInfo, nullptr,
+                        &_timestampPool) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create timestamp query pool!");
+  }
+  _timestampPending.assign(images, false);
+  _timestampKernel.assign(images, Rasterizer::PerPixel);
+  _pathTimestampMask.assign(images, 0);
+  _displayedMode.assign(images, RenderMode::Sorted);
+  _preprocessQueryBase = uint32_t(TIMESTAMPS_PER_IMAGE * images);
+}
+
+void ComputePipeline::ReadRenderTimestamps(uint32_t imageIndex) {
+  if (_timestampPool == VK_NULL_HANDLE) {
+    return;
+  }
+
+  uint32_t base = TIMESTAMPS_PER_IMAGE * imageIndex;
+  uint64_t ticks[2];
+
+  // Moving average of each render path, for the side by side report. Only
+  // the path on screen counts towards the frame time
+  float pathMs = 0.0f;
+  for (uint32_t mode = 0; mode < NUM_RENDER_MODES; mode++) {
+    if ((_pathTimestampMask[imageIndex] & (1u << mode)) == 0 ||
+        vkGetQueryPoolResults(_vkContext.GetLogicalDevice(), _timestampPool,
+                              base + 4 + 2 * mode, 2, sizeof(ticks), ticks,
+                              sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+      continue;
+    }
+    float ms = float(double(ticks[1] - ticks[0]) * _timestampPeriod * 1e-6);
+    float &avg = g_renderSettings.pathTimeMs[mode];
+    avg = avg == 0.0f ? ms : 0.9f * avg + 0.1f * ms;
+    if (RenderMode(mode) == _displayedMode[imageIndex]) {
+      pathMs = ms;
+    }
+  }
+  if (_pathTimestampMask[imageIndex] != 0) {
+    _renderMs = pathMs;
+  }
+  _pathTimestampMask[imageIndex] = 0;
+
+  if (!_timestampPending[imageIndex]) {
+    return;
+  }
+
+  VkResult result = vkGetQueryPoolResults(
+      _vkContext.GetLogicalDevice(), _timestampPool, base, 2, sizeof(ticks),
+      ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+  _timestampPending[imageIndex] = false;
+  if (result != VK_SUCCESS) {
+    return;
+  }
+
+  float ms = float(double(ticks[1] - ticks[0]) * _timestampPeriod * 1e-6);
+  g_renderSettings.rasterTimeMs = ms;
+  if (vkGetQueryPoolResults(_vkContext.GetLogicalDevice(), _timestampPool,
+                            base + 2, 2, sizeof(ticks), ticks,
+                            sizeof(uint64_t),
+                            VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+    g_renderSettings.tileIdTimeMs =
+        float(double(ticks[1] - ticks[0]) * _timestampPeriod * 1e-6);
+  }
+
+  Rasterizer kernel = _timestampKernel[imageIndex];
+  if (!_rasterBenchDone && kernel != Rasterizer::Auto) {
+    _rasterTimeMs[kernel] += ms;
+    _rasterSamples[kernel]++;
+  }
+}
+
+Rasterizer ComputePipeline::SelectRasterizer() {
+  // (Re)start the benchmark whenever the selection changes, so picking Auto
+  // again re-measures the current scene
+  if (g_renderSettings.rasterizer != _lastRasterizer) {
+    _lastRasterizer = g_renderSettings.rasterizer;
+    _rasterBenchDone = _timestampPool == VK_NULL_HANDLE;
+    _rasterBenchFrame = 0;
+    _rasterTimeMs.clear();
+    _rasterSamples.clear();
+  }
+
+  Rasterizer selected = Rasterizer(g_renderSettings.rasterizer);
+  if (selected != Rasterizer::Auto) {
+    return selected;
+  }
+  if (_rasterBenchDone) {
+    return _autoRasterizer;
+  }
+
+  for (const auto &[kernel, pipeline] : _rasterKernels) {
+    if (_rasterSamples[kernel] < RASTER_BENCH_FRAMES) {
+      // Round robin until every kernel has enough samples
+      auto next = std::next(_rasterKernels.begin(),
+                            _rasterBenchFrame++ % _rasterKernels.size());
+      return next->first;
+    }
+  }
+
+  double best = std::numeric_limits<double>::max();
+  for (const auto &[kernel, pipeline] : _rasterKernels) {
+    double avg = _rasterTimeMs[kernel] / _rasterSamples[kernel];
+    std::cout << "Rasterizer " << (int)kernel << ": " << avg << " ms"
+              << std::endl;
+    if (avg < best) {
+      best = avg;
+      _autoRasterizer = kernel;
+    }
+  }
+  _rasterBenchDone = true;
+  std::cout << "Auto rasterizer picked " << (int)_autoRasterizer << std::endl;
+  return _autoRasterizer;
+}
+
+int ComputePipeline::getRadixIterations() {
+  VkExtent2D tileGrid = GetTileGrid();
+  uint32_t nTiles = tileGrid.width * tileGrid.height;
   uint32_t tileBits = static_cast<uint32_t>(std::ceil(std::log2(nTiles)));
   uint32_t totalBits = 32 + tileBits;
   return (totalBits + 7) / 8;
@@ -999,14 +2637,19 @@ void ComputePipeline::resizeBuffers(float size) {
   VkPhysicalDevice physicalDevice = _vkContext.GetPhysicalDevice();
   VkDevice device = _vkContext.GetLogicalDevice();
 
+  // Frames in flight may still reference the old buffers
+  vkDeviceWaitIdle(device);
+
   _buffManager->DestroyBuffer(device, _gaussianBuffers.valuesRadix);
   _buffManager->DestroyBuffer(device, _gaussianBuffers.values);
   _buffManager->DestroyBuffer(device, _gaussianBuffers.keys);
   _buffManager->DestroyBuffer(device, _gaussianBuffers.keysRadix);
   _buffManager->DestroyBuffer(device, _gaussianBuffers.histogram);
+  _buffManager->DestroyBuffer(device, _gaussianBuffers.records);
 
   VkDeviceSize bufferSizeKey = sizeof(int64_t) * int(size);
   VkDeviceSize bufferSizeValue = sizeof(int32_t) * int(size);
+  VkDeviceSize bufferSizeRecord = sizeof(SplatRecord) * int(size);
 
   uint32_t elementsPerWorkgroup =
       WORKGROUP_SIZE * blocks_per_workgroup; // 256 * 32 = 8192
@@ -1033,6 +2676,9 @@ void ComputePipeline::resizeBuffers(float size) {
   _gaussianBuffers.histogram =
       _buffManager->CreateBuffer(device, physicalDevice, histogramSize, usage,
                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _gaussianBuffers.records =
+      _buffManager->CreateBuffer(device, physicalDevice, bufferSizeRecord,
+                                 usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
   _sizeBufferMax = uint32_t(size);
   UpdateAllDescriptorSets(PipelineType::ASSIGN_TILE_IDS);
   UpdateAllDescriptorSets(PipelineType::RADIX_HISTOGRAM_0);
@@ -1040,7 +2686,10 @@ void ComputePipeline::resizeBuffers(float size) {
   UpdateAllDescriptorSets(PipelineType::RADIX_SCATTER_0);
   UpdateAllDescriptorSets(PipelineType::RADIX_SCATTER_1);
   UpdateAllDescriptorSets(PipelineType::TILE_BOUNDARIES);
+  UpdateAllDescriptorSets(PipelineType::PACK_SPLATS);
   UpdateAllDescriptorSets(PipelineType::RENDER);
+  UpdateAllDescriptorSets(PipelineType::DEPTH_KEYS);
+  _splatRasterPipeline.SetSortedList(_gaussianBuffers.values);
 
   std::cout << "resize Buffers and update Descriptors" << std::endl;
 }
@@ -1090,9 +2739,10 @@ void ComputePipeline::clearSwapchain(VkCommandBuffer commandBuffer,
 void ComputePipeline::createRenderTarget() {
 
   // Get swapchain extent
-  VkExtent2D extent = _vkContext.GetSwapchainExtent();
-  uint32_t width = extent.width / _windowResize;
-  uint32_t height = extent.height / _windowResize;
+  // Native size, dynamic resolution renders into a part of it
+  VkExtent2D extent = GetNativeExtent();
+  uint32_t width = extent.width;
+  uint32_t height = extent.height;
 
   // Create image
   VkImageCreateInfo imageInfo{};
@@ -1104,7 +2754,9 @@ void ComputePipeline::createRenderTarget() {
   imageInfo.arrayLayers = 1;
   imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
   imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-  imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+  imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
   imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
   imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
@@ -10,6 +10,7 @@ int VulkanContext::InitContext() {
     SetupDebugMessenger();
     CreateSurface();
     GetPhysicalDeviceInternal();
+    QuerySubgroupInfo();
     CreateLogicalDevice();
     CreateSwapChain();
     CreateCommandPool();
@@ -152,9 +153,19 @@ void VulkanContext::CreateLogicalDevice() {
     }
 #endif
 
+    VkPhysicalDeviceSubgroupSizeControlFeaturesEXT sizeControlFeatures{};
+    sizeControlFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT;
+    sizeControlFeatures.subgroupSizeControl = _vcxSubgroupInfo.sizeControl;
+    sizeControlFeatures.computeFullSubgroups = _vcxSubgroupInfo.fullSubgroups;
+    if (_vcxSubgroupInfo.sizeControl) {
+        requiredExtensions.push_back(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
+    }
+
     VkPhysicalDeviceVulkan12Features vulkan12Features{};
     vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
-    vulkan12Features.pNext = nullptr;
+    vulkan12Features.pNext =
+        _vcxSubgroupInfo.sizeControl ? &sizeControlFeatures : nullptr;
 #ifndef __APPLE__
     vulkan12Features.shaderSharedInt64Atomics = VK_TRUE;
     vulkan12Features.shaderBufferInt64Atomics = VK_TRUE;
@@ -189,6 +200,66 @@ void VulkanContext::CreateLogicalDevice() {
     std::cout << "---VkLogicalDevice created Successfully---" << std::endl;
 }
 
+void VulkanContext::QuerySubgroupInfo() {
+  VkPhysicalDevice device = _vcxMainDevice.physicalDevice;
+
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                       nullptr);
+  std::vector<VkExtensionProperties> extensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                       extensions.data());
+  bool hasSizeControl = false;
+  for (const auto &extension : extensions) {
+    if (strcmp(extension.extensionName,
+               VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME) == 0) {
+      hasSizeControl = true;
+    }
+  }
+
+  VkPhysicalDeviceSubgroupSizeControlPropertiesEXT sizeControlProperties{};
+  sizeControlProperties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES_EXT;
+  VkPhysicalDeviceSubgroupProperties subgroupProperties{};
+  subgroupProperties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+  subgroupProperties.pNext = hasSizeControl ? &sizeControlProperties : nullptr;
+  VkPhysicalDeviceProperties2 properties2{};
+  properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties2.pNext = &subgroupProperties;
+  vkGetPhysicalDeviceProperties2(device, &properties2);
+
+  // Without the extension nothing bounds the size a dispatch may run with
+  _vcxSubgroupInfo.size = subgroupProperties.subgroupSize;
+  _vcxSubgroupInfo.minSize = 1;
+  _vcxSubgroupInfo.maxSize = subgroupProperties.subgroupSize;
+
+  if (hasSizeControl) {
+    VkPhysicalDeviceSubgroupSizeControlFeaturesEXT sizeControlFeatures{};
+    sizeControlFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &sizeControlFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+
+    _vcxSubgroupInfo.sizeControl =
+        sizeControlFeatures.subgroupSizeControl &&
+        (sizeControlProperties.requiredSubgroupSizeStages &
+         VK_SHADER_STAGE_COMPUTE_BIT);
+    _vcxSubgroupInfo.fullSubgroups =
+        _vcxSubgroupInfo.sizeControl && sizeControlFeatures.computeFullSubgroups;
+    _vcxSubgroupInfo.minSize = sizeControlProperties.minSubgroupSize;
+    _vcxSubgroupInfo.maxSize = sizeControlProperties.maxSubgroupSize;
+  }
+
+  std::cout << "Subgroup size: " << _vcxSubgroupInfo.size << " (min "
+            << _vcxSubgroupInfo.minSize << ", max " << _vcxSubgroupInfo.maxSize
+            << ", size control " << _vcxSubgroupInfo.sizeControl
+            << ", full subgroups " << _vcxSubgroupInfo.fullSubgroups << ")"
+            << std::endl;
+}
+
 void VulkanContext::CreateSwapChain() {
 
   // CHoose best swapchainfeature
@@ -220,7 +291,8 @@ void VulkanContext::CreateSwapChain() {
   createInfo.imageArrayLayers = 1; // number of layers per each array
   createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
                           VK_IMAGE_USAGE_STORAGE_BIT |
-                          VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+                          VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                          VK_IMAGE_USAGE_TRANSFER_SRC_BIT; // A/B capture
   // normally in swapchain always color
   createInfo.preTransform = swChainDetails.surfaceCapabilities.currentTransform;
   createInfo.compositeAlpha =
@@ -20,6 +20,21 @@ void GaussianRenderer::LoadGaussianData(
 
   _gaussianData = std::move(gaussianData);
 
+  // SH bands below the tolerance are dropped per Gaussian before upload
+  size_t denseBytes = _gaussianData->GetCount() * 3 *
+                      _gaussianData->GetSHCoefficientsPerChannel() *
+                      sizeof(float);
+  // Clusters of one preprocess workgroup each, for the cluster culling
+  _gaussianData->BuildClusters(WORKGROUP_SIZE);
+  _gaussianData->BuildSHPlanes(g_renderSettings.shTolerance);
+  g_renderSettings.shBytesDense = denseBytes;
+  g_renderSettings.shBytes = 0;
+  for (int band = 0; band < 4; band++) {
+    g_renderSettings.shBytes += _gaussianData->GetSHPlaneBytes(band);
+  }
+  g_renderSettings.shDegreeMax = _gaussianData->GetSHDegree();
+  g_renderSettings.shDegrees = g_renderSettings.shDegreeMax;
+
   _nGauss = uint32_t(_gaussianData->GetCount());
   std::cout << " Gaussian data loaded!" << std::endl;
 }
@@ -41,7 +56,25 @@ void GaussianRenderer::CreateBuffers() {
   _computePipeline.setBufferManager(&_bufferManager);
 }
 
-void GaussianRenderer::Render() { _computePipeline.RenderFrame(*_camera); }
+void GaussianRenderer::Render() {
+  // A setting check measures consecutive rendered frames of one view
+  bool checking =
+      g_renderSettings.settingCheck != int(SettingCheck::None) ||
+      g_renderSettings.settingCheckRunning;
+  if (_sceneChanged || !g_renderSettings.idleSkip || checking) {
+    _settleFrames = IDLE_SETTLE_FRAMES;
+  }
+  g_renderSettings.idle =
+      _settleFrames == 0 && _computePipeline.HasCachedFrame();
+  if (g_renderSettings.idle) {
+    _computePipeline.PresentCachedFrame(*_camera);
+    return;
+  }
+
+  // The last settle frame is the one re-presented while idle
+  _settleFrames = std::max(_settleFrames - 1, 0);
+  _computePipeline.RenderFrame(*_camera, _settleFrames == 0);
+}
 
 void GaussianRenderer::InitializeCamera(float windowWidth, float windowHeight) {
   float aspectRatio = windowWidth / windowHeight;
@@ -142,13 +175,55 @@ void GaussianRenderer::CreateGaussianBuffers() {
                                    _gaussianData->GetRotationsData(), "_rot");
   CreateAndUploadBuffer<float>(_buffers.opacity,
                                _gaussianData->GetOpacitiesData(), "_opacity");
-  CreateAndUploadBuffer<float>(
-      _buffers.sh, _gaussianData->GetSHData(), "_SH",
-      3 * (_gaussianData->GetSHCoefficientsPerChannel()));
+  UploadBuffer(_buffers.clusterBounds, _gaussianData->GetClusterBoundsData(),
+               "_clusterBounds",
+               _gaussianData->GetClusterCount() * 2 * sizeof(glm::vec4));
+  _buffers.visibleClusters = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      _gaussianData->GetClusterCount() * sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  VkBuffer *planes[4] = {&_buffers.sh, &_buffers.shBand1, &_buffers.shBand2,
+                         &_buffers.shBand3};
+  for (int band = 0; band < 4; band++) {
+    UploadBuffer(*planes[band], _gaussianData->GetSHPlaneData(band),
+                 "_SH" + std::to_string(band),
+                 _gaussianData->GetSHPlaneBytes(band));
+  }
+}
+
+void GaussianRenderer::UploadBuffer(VkBuffer &buffer, const void *data,
+                                    std::string type, VkDeviceSize bufferSize) {
+  VkDevice device = _vulkanContext.GetLogicalDevice();
+  VkPhysicalDevice physicalDevice = _vulkanContext.GetPhysicalDevice();
+
+  std::cout << " Creating " << type << " buffer : " << bufferSize << " bytes "
+            << std::endl;
+  buffer =
+      _bufferManager.CreateStorageBuffer(device, physicalDevice, bufferSize);
+
+  VkBuffer stagingBuffer = _bufferManager.CreateBuffer(
+      device, physicalDevice, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  void *mappedMem;
+  VkDeviceMemory deviceMem = _bufferManager.GetBufferMemory(stagingBuffer);
+  vkMapMemory(device, deviceMem, 0, bufferSize, 0, &mappedMem);
+  memcpy(mappedMem, data, static_cast<size_t>(bufferSize));
+  vkUnmapMemory(device, deviceMem);
+
+  _bufferManager.copyBuffer(device, bufferSize, stagingBuffer, buffer,
+                            _vulkanContext.GetCommandPool(),
+                            _vulkanContext.GetGraphicsQueue());
+
+  _bufferManager.DestroyBuffer(device, stagingBuffer);
+
+  std::cout << " buffer created!" << std::endl;
 }
 
 void GaussianRenderer::CreatePipelineStorageBuffers() {
-  CreateWriteBuffers<int>(_buffers.radii, "radii", 1);
+  CreateWriteBuffers<int>(_buffers.radii, "radii", 1, true);
   CreateWriteBuffers<float>(_buffers.depth, "depth", 1);
   CreateWriteBuffers<glm::vec4>(_buffers.color, "color");
   CreateWriteBuffers<glm::vec4>(_buffers.conicOpacity, "conicOpacity");
@@ -162,11 +237,58 @@ void GaussianRenderer::CreatePipelineStorageBuffers() {
   CreateWriteBuffers<uint32_t>(_buffers.values, "values", 10, true);
   CreateWriteBuffers<uint32_t>(_buffers.valuesRadix, "valuesRadix", 10, true);
   CreateWriteBuffers<uint32_t>(_buffers.histogram, "histogram", 10, true);
+  CreateWriteBuffers<uint32_t>(_buffers.visibleList, "visibleList", 1, true);
+  // Sized per key like the sort buffers, grown by resizeBuffers
+  CreateWriteBuffers<SplatRecord>(_buffers.records, "records", 1, true);
+  CreateWriteBuffers<glm::uvec4>(_buffers.colorCache, "colorCache", 1, true);
+  // Fixed size: written by preprocess before the key count is known, tall
+  // splats that find it full fall back to walking their rows in idkeys
+  CreateWriteBuffers<glm::uvec2>(_buffers.rowSpans, "rowSpans", 1, true);
+  CreateWriteBuffers<glm::uvec2>(_buffers.rowTables, "rowTables", 1, true);
+  _buffers.budgetHistogram = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      SPLAT_BUDGET_BINS * sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
   CreateRangesBuffer();
+  CreateSplitBuffers();
+
+  // Identity start order for the temporal sort, rebuilt on the first frame
+  std::vector<uint32_t> order(_nGauss);
+  std::iota(order.begin(), order.end(), 0u);
+  CreateAndUploadBuffer<uint32_t>(_buffers.sortOrder, order.data(),
+                                  "sortOrder");
+  CreateCountersBuffer();
 }
 void GaussianRenderer::UpdateCameraUniforms() {
   CameraUniforms uniforms = _camera->getUniforms();
-  uniforms.shDegree = _shDegree;
+  // Lower degrees only read the SH planes up to them
+  uniforms.shDegree = std::clamp(g_renderSettings.shDegrees, 0, _shDegree);
+
+  // Dynamic resolution: same field of view on the smaller render extent
+  if (g_renderSettings.renderWidth > 0) {
+    uniforms.focal_x *=
+        float(g_renderSettings.renderWidth) / float(uniforms.imageWidth);
+    uniforms.focal_y *=
+        float(g_renderSettings.renderHeight) / float(uniforms.imageHeight);
+    uniforms.imageWidth = g_renderSettings.renderWidth;
+    uniforms.imageHeight = g_renderSettings.renderHeight;
+  }
+
+  // The image size and focal lengths follow the resolution controller and
+  // are left out, see RenderSettings::ImageInputs
+  auto inputs = g_renderSettings.ImageInputs();
+  _sceneChanged = inputs != _lastInputs ||
+                  uniforms.viewMatrix != _lastUniforms.viewMatrix ||
+                  uniforms.projMatrix != _lastUniforms.projMatrix ||
+                  uniforms.camPos != _lastUniforms.camPos ||
+                  uniforms.shDegree != _lastUniforms.shDegree;
+  _lastInputs = inputs;
+  _lastUniforms = uniforms;
+
+  // Occlusion culling reprojects the previous frame's tile depths
+  uniforms.prevViewProj = _prevViewProj;
+  _prevViewProj = uniforms.projMatrix * uniforms.viewMatrix;
 
   CameraUniforms *gpuData = (CameraUniforms *)_cameraUniformMapped;
 
@@ -211,18 +333,62 @@ void GaussianRenderer::CreateCopyStagingBuffer() {
               bufferSize, 0, &_buffers.numRendered.mem);
 }
 
+void GaussianRenderer::CreateCountersBuffer() {
+  _buffers.counters = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(uint32_t) * NUM_COUNTERS,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+          VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
 void GaussianRenderer::CreateRangesBuffer() {
   VkExtent2D ext = _vulkanContext.GetSwapchainExtent();
   int windowResize = 1;
 #ifdef __APPLE__
   windowResize = 2;
 #endif
-  int tiles = (ext.width / windowResize + 15) / 16 *
-              (ext.height / windowResize + 15) / 16;
+  // Enough tiles for the smallest preset, so the tile size can change at
+  // runtime without reallocating
+  int tiles = ((ext.width / windowResize + MIN_TILE_SIZE - 1) / MIN_TILE_SIZE) *
+              ((ext.height / windowResize + MIN_TILE_SIZE - 1) / MIN_TILE_SIZE);
 
   _buffers.ranges = _bufferManager.CreateBuffer(
       _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
       sizeof(glm::vec2) * tiles,
-      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _buffers.activeTiles = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(uint32_t) * tiles, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _buffers.tileDepth = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(float) * tiles,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _buffers.tileSplit = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(glm::uvec2) * tiles, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 }
+
+void GaussianRenderer::CreateSplitBuffers() {
+  // Work items and per-pixel partial results of split tiles. The partials
+  // are sized for the largest tile preset, the work items for the number of
+  // chunks that fit in them at the smallest
+  _buffers.tileWork = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(glm::uvec4) * MAX_SPLIT_WORK,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _buffers.partials = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(glm::vec4) * MAX_SPLIT_CHUNKS * MAX_TILE_PIXELS,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  _buffers.partialDepths = _bufferManager.CreateBuffer(
+      _vulkanContext.GetLogicalDevice(), _vulkanContext.GetPhysicalDevice(),
+      sizeof(uint32_t) * MAX_SPLIT_CHUNKS * MAX_TILE_PIXELS,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
@@ -0,0 +1,531 @@
+// Vulkan 3DGS - Copyright (c) 2025 Alejandro Amat (github.com/AlejandroAmat) -
+// MIT Licensed
+
+#include "SplatRasterPipeline.h"
+#include <array>
+#include <iostream>
+#include <stdexcept>
+
+// Format of the splat raster targets; rgba16f is storage and blendable
+// everywhere
+const VkFormat WBOIT_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+SplatRasterPipeline::~SplatRasterPipeline() { CleanUp(); }
+
+void SplatRasterPipeline::Init(const GaussianBuffers &buffers,
+                               VkExtent2D extent) {
+  _extent = extent;
+  CreateAttachment(_accum, WBOIT_FORMAT);
+  CreateAttachment(_reveal, WBOIT_FORMAT);
+  _wboitRenderPass = CreateRenderPass(2);
+  _sortedRenderPass = CreateRenderPass(1);
+  _wboitFrameBuffer =
+      CreateFrameBuffer(_wboitRenderPass, {_accum.view, _reveal.view});
+  _sortedFrameBuffer = CreateFrameBuffer(_sortedRenderPass, {_accum.view});
+  CreateDescriptors(buffers);
+  CreatePipelineLayout();
+
+  const VkColorComponentFlags allChannels =
+      VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+      VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+  // accum += src
+  std::vector<VkPipelineColorBlendAttachmentState> wboitBlend(2);
+  wboitBlend[0].colorWriteMask = allChannels;
+  wboitBlend[0].blendEnable = VK_TRUE;
+  wboitBlend[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+  wboitBlend[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+  wboitBlend[0].colorBlendOp = VK_BLEND_OP_ADD;
+  wboitBlend[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  wboitBlend[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  wboitBlend[0].alphaBlendOp = VK_BLEND_OP_ADD;
+
+  // reveal *= 1 - src
+  wboitBlend[1].colorWriteMask = allChannels;
+  wboitBlend[1].blendEnable = VK_TRUE;
+  wboitBlend[1].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+  wboitBlend[1].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+  wboitBlend[1].colorBlendOp = VK_BLEND_OP_ADD;
+  wboitBlend[1].srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+  wboitBlend[1].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  wboitBlend[1].alphaBlendOp = VK_BLEND_OP_ADD;
+
+  // Front to back "under": dst += (1 - dst.a) * src, src premultiplied
+  std::vector<VkPipelineColorBlendAttachmentState> sortedBlend(1);
+  sortedBlend[0].colorWriteMask = allChannels;
+  sortedBlend[0].blendEnable = VK_TRUE;
+  sortedBlend[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+  sortedBlend[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+  sortedBlend[0].colorBlendOp = VK_BLEND_OP_ADD;
+  sortedBlend[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+  sortedBlend[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  sortedBlend[0].alphaBlendOp = VK_BLEND_OP_ADD;
+
+  _wboitPipeline = CreatePipeline("Shaders/splat_wboit_frag.spv",
+                                  _wboitRenderPass, wboitBlend);
+  _sortedPipeline = CreatePipeline("Shaders/splat_over_frag.spv",
+                                   _sortedRenderPass, sortedBlend);
+  std::cout << "Splat Raster Pipeline created" << std::endl;
+}
+
+void SplatRasterPipeline::CreateAttachment(Attachment &attachment,
+                                           VkFormat format) {
+  VkDevice device = _vkContext.GetLogicalDevice();
+
+  VkImageCreateInfo imageInfo{};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = format;
+  imageInfo.extent = {_extent.width, _extent.height, 1};
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage =
+      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  if (vkCreateImage(device, &imageInfo, nullptr, &attachment.image) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat raster attachment!");
+  }
+
+  VkMemoryRequirements memRequirements;
+  vkGetImageMemoryRequirements(device, attachment.image, &memRequirements);
+
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = memRequirements.size;
+  allocInfo.memoryTypeIndex = FindMemoryType(
+      memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  if (vkAllocateMemory(device, &allocInfo, nullptr, &attachment.memory) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to allocate splat raster attachment!");
+  }
+  vkBindImageMemory(device, attachment.image, attachment.memory, 0);
+
+  VkImageViewCreateInfo viewInfo{};
+  viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  viewInfo.image = attachment.image;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  viewInfo.format = format;
+  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewInfo.subresourceRange.baseMipLevel = 0;
+  viewInfo.subresourceRange.levelCount = 1;
+  viewInfo.subresourceRange.baseArrayLayer = 0;
+  viewInfo.subresourceRange.layerCount = 1;
+
+  if (vkCreateImageView(device, &viewInfo, nullptr, &attachment.view) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat raster image view!");
+  }
+}
+
+VkRenderPass SplatRasterPipeline::CreateRenderPass(uint32_t numAttachments) {
+  // The targets are cleared every frame and left in GENERAL for the resolve
+  // pass, which reads them as storage images
+  std::vector<VkAttachmentDescription> attachments(numAttachments);
+  for (auto &attachment : attachments) {
+    attachment.format = WBOIT_FORMAT;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+  }
+
+  std::vector<VkAttachmentReference> colorRefs(numAttachments);
+  for (uint32_t i = 0; i < numAttachments; i++) {
+    colorRefs[i] = {i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+  }
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = uint32_t(colorRefs.size());
+  subpass.pColorAttachments = colorRefs.data();
+
+  // In: the previous resolve may still be reading the targets, and preprocess
+  // wrote the splat data. Out: the resolve reads what was blended here
+  std::array<VkSubpassDependency, 2> dependencies = {};
+  dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[0].dstSubpass = 0;
+  dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[0].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  dependencies[0].dstStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[0].dstAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  dependencies[1].srcSubpass = 0;
+  dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+  VkRenderPassCreateInfo renderPassInfo = {};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  renderPassInfo.attachmentCount = uint32_t(attachments.size());
+  renderPassInfo.pAttachments = attachments.data();
+  renderPassInfo.subpassCount = 1;
+  renderPassInfo.pSubpasses = &subpass;
+  renderPassInfo.dependencyCount = uint32_t(dependencies.size());
+  renderPassInfo.pDependencies = dependencies.data();
+
+  VkRenderPass renderPass;
+  if (vkCreateRenderPass(_vkContext.GetLogicalDevice(), &renderPassInfo,
+                         nullptr, &renderPass) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat raster render pass!");
+  }
+  return renderPass;
+}
+
+VkFramebuffer
+SplatRasterPipeline::CreateFrameBuffer(VkRenderPass renderPass,
+                                       const std::vector<VkImageView> &views) {
+  VkFramebufferCreateInfo framebufferInfo = {};
+  framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  framebufferInfo.renderPass = renderPass;
+  framebufferInfo.attachmentCount = uint32_t(views.size());
+  framebufferInfo.pAttachments = views.data();
+  framebufferInfo.width = _extent.width;
+  framebufferInfo.height = _extent.height;
+  framebufferInfo.layers = 1;
+
+  VkFramebuffer frameBuffer;
+  if (vkCreateFramebuffer(_vkContext.GetLogicalDevice(), &framebufferInfo,
+                          nullptr, &frameBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat raster framebuffer!");
+  }
+  return frameBuffer;
+}
+
+void SplatRasterPipeline::CreateDescriptors(const GaussianBuffers &buffers) {
+  VkDevice device = _vkContext.GetLogicalDevice();
+
+  // Same binding order as splat_quad.vert
+  std::array<VkBuffer, 6> splatBuffers = {
+      buffers.visibleList, buffers.radii,        buffers.depth,
+      buffers.points2d,    buffers.conicOpacity, buffers.color};
+
+  std::array<VkDescriptorSetLayoutBinding, 6> bindings = {};
+  for (uint32_t i = 0; i < bindings.size(); i++) {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  }
+
+  VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layoutInfo.bindingCount = uint32_t(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+
+  if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr,
+                                  &_descriptorSetLayout) != VK_SUCCESS) {
+    throw std::runtime_error(
+        "Failed to create splat raster descriptor set layout!");
+  }
+
+  // One set per instance order
+  VkDescriptorPoolSize poolSize = {};
+  poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  poolSize.descriptorCount = 2 * uint32_t(bindings.size());
+
+  VkDescriptorPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.poolSizeCount = 1;
+  poolInfo.pPoolSizes = &poolSize;
+  poolInfo.maxSets = 2;
+
+  if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &_descriptorPool) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat raster descriptor pool!");
+  }
+
+  // None of the splat buffers is ever reallocated, so one set per instance
+  // order serves every frame
+  std::array<VkDescriptorSetLayout, 2> setLayouts = {_descriptorSetLayout,
+                                                     _descriptorSetLayout};
+  std::array<VkDescriptorSet, 2> sets = {};
+  VkDescriptorSetAllocateInfo allocInfo = {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorPool = _descriptorPool;
+  allocInfo.descriptorSetCount = uint32_t(setLayouts.size());
+  allocInfo.pSetLayouts = setLayouts.data();
+
+  if (vkAllocateDescriptorSets(device, &allocInfo, sets.data()) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Failed to allocate splat raster descriptor set!");
+  }
+  _visibleSet = sets[0];
+  _sortedSet = sets[1];
+
+  for (uint32_t i = 0; i < splatBuffers.size(); i++) {
+    WriteBuffer(_visibleSet, i, splatBuffers[i]);
+    WriteBuffer(_sortedSet, i, splatBuffers[i]);
+  }
+  SetSortedList(buffers.values);
+}
+
+void SplatRasterPipeline::WriteBuffer(VkDescriptorSet set, uint32_t binding,
+                                      VkBuffer buffer) {
+  VkDescriptorBufferInfo bufferInfo = {};
+  bufferInfo.buffer = buffer;
+  bufferInfo.offset = 0;
+  bufferInfo.range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet write = {};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = set;
+  write.dstBinding = binding;
+  write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  write.descriptorCount = 1;
+  write.pBufferInfo = &bufferInfo;
+  vkUpdateDescriptorSets(_vkContext.GetLogicalDevice(), 1, &write, 0, nullptr);
+}
+
+void SplatRasterPipeline::SetSortedList(VkBuffer sortedList) {
+  WriteBuffer(_sortedSet, 0, sortedList);
+}
+
+void SplatRasterPipeline::CreatePipelineLayout() {
+  // width, height, depthScale
+  VkPushConstantRange pushRange = {};
+  pushRange.stageFlags =
+      VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+  pushRange.offset = 0;
+  pushRange.size = 3 * sizeof(uint32_t);
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+
+  if (vkCreatePipelineLayout(_vkContext.GetLogicalDevice(),
+                             &pipelineLayoutInfo, nullptr,
+                             &_pipelineLayout) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat raster pipeline layout!");
+  }
+}
+
+VkPipeline SplatRasterPipeline::CreatePipeline(
+    const std::string &fragShader, VkRenderPass renderPass,
+    const std::vector<VkPipelineColorBlendAttachmentState> &blendStates) {
+  VkDevice device = _vkContext.GetLogicalDevice();
+
+  auto vertShaderCode =
+      ReadFile(g_renderSettings.shaderPath + "Shaders/splat_quad_vert.spv");
+  auto fragShaderCode = ReadFile(g_renderSettings.shaderPath + fragShader);
+
+  VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
+  VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
+
+  std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages = {};
+  shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+  shaderStages[0].module = vertShaderModule;
+  shaderStages[0].pName = "main";
+  shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+  shaderStages[1].module = fragShaderModule;
+  shaderStages[1].pName = "main";
+
+  // Quads are generated from gl_VertexIndex and gl_InstanceIndex
+  VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+  vertexInputInfo.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+  VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+  inputAssembly.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+  inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+  // Set per pass from the render extent
+  VkPipelineViewportStateCreateInfo viewportState = {};
+  viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  viewportState.viewportCount = 1;
+  viewportState.scissorCount = 1;
+
+  std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                 VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo dynamicState = {};
+  dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  dynamicState.dynamicStateCount = uint32_t(dynamicStates.size());
+  dynamicState.pDynamicStates = dynamicStates.data();
+
+  VkPipelineRasterizationStateCreateInfo rasterizer = {};
+  rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  rasterizer.depthClampEnable = VK_FALSE;
+  rasterizer.rasterizerDiscardEnable = VK_FALSE;
+  rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+  rasterizer.lineWidth = 1.0f;
+  rasterizer.cullMode = VK_CULL_MODE_NONE;
+  rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  rasterizer.depthBiasEnable = VK_FALSE;
+
+  VkPipelineMultisampleStateCreateInfo multisampling = {};
+  multisampling.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  multisampling.sampleShadingEnable = VK_FALSE;
+  multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+  VkPipelineColorBlendStateCreateInfo colorBlending = {};
+  colorBlending.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  colorBlending.logicOpEnable = VK_FALSE;
+  colorBlending.attachmentCount = uint32_t(blendStates.size());
+  colorBlending.pAttachments = blendStates.data();
+
+  VkGraphicsPipelineCreateInfo pipelineInfo = {};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  pipelineInfo.stageCount = uint32_t(shaderStages.size());
+  pipelineInfo.pStages = shaderStages.data();
+  pipelineInfo.pVertexInputState = &vertexInputInfo;
+  pipelineInfo.pInputAssemblyState = &inputAssembly;
+  pipelineInfo.pViewportState = &viewportState;
+  pipelineInfo.pRasterizationState = &rasterizer;
+  pipelineInfo.pMultisampleState = &multisampling;
+  pipelineInfo.pColorBlendState = &colorBlending;
+  pipelineInfo.pDynamicState = &dynamicState;
+  pipelineInfo.layout = _pipelineLayout;
+  pipelineInfo.renderPass = renderPass;
+  pipelineInfo.subpass = 0;
+
+  VkPipeline pipeline;
+  if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                                nullptr, &pipeline) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create splat graphics pipeline!");
+  }
+
+  vkDestroyShaderModule(device, fragShaderModule, nullptr);
+  vkDestroyShaderModule(device, vertShaderModule, nullptr);
+  return pipeline;
+}
+
+void SplatRasterPipeline::RecordWboitPass(VkCommandBuffer commandBuffer,
+                                          uint32_t numVisible,
+                                          float depthScale) {
+  std::vector<VkClearValue> clearValues(2);
+  clearValues[0].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+  clearValues[1].color = {{1.0f, 1.0f, 1.0f, 1.0f}};
+  RecordQuads(commandBuffer, _wboitRenderPass, _wboitFrameBuffer,
+              _wboitPipeline, _visibleSet, clearValues, numVisible,
+              depthScale);
+}
+
+void SplatRasterPipeline::RecordSortedPass(VkCommandBuffer commandBuffer,
+                                           uint32_t numVisible) {
+  std::vector<VkClearValue> clearValues(1);
+  clearValues[0].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+  RecordQuads(commandBuffer, _sortedRenderPass, _sortedFrameBuffer,
+              _sortedPipeline, _sortedSet, clearValues, numVisible, 1.0f);
+}
+
+void SplatRasterPipeline::RecordQuads(
+    VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+    VkFramebuffer frameBuffer, VkPipeline pipeline, VkDescriptorSet set,
+    const std::vector<VkClearValue> &clearValues, uint32_t numInstances,
+    float depthScale) {
+  VkRenderPassBeginInfo renderPassInfo = {};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  renderPassInfo.renderPass = renderPass;
+  renderPassInfo.framebuffer = frameBuffer;
+  renderPassInfo.renderArea.offset = {0, 0};
+  renderPassInfo.renderArea.extent = _renderExtent;
+  renderPassInfo.clearValueCount = uint32_t(clearValues.size());
+  renderPassInfo.pClearValues = clearValues.data();
+
+  vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+                       VK_SUBPASS_CONTENTS_INLINE);
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          _pipelineLayout, 0, 1, &set, 0, nullptr);
+
+  VkViewport viewport = {};
+  viewport.width = float(_renderExtent.width);
+  viewport.height = float(_renderExtent.height);
+  viewport.maxDepth = 1.0f;
+  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+  VkRect2D scissor = {{0, 0}, _renderExtent};
+  vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+  struct {
+    uint32_t width;
+    uint32_t height;
+    float depthScale;
+  } pc = {_renderExtent.width, _renderExtent.height, depthScale};
+  vkCmdPushConstants(commandBuffer, _pipelineLayout,
+                     VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                     0, sizeof(pc), &pc);
+
+  // One instanced strip of 4 vertices per Gaussian
+  vkCmdDraw(commandBuffer, 4, numInstances, 0, 0);
+
+  vkCmdEndRenderPass(commandBuffer);
+}
+
+VkShaderModule
+SplatRasterPipeline::CreateShaderModule(const std::vector<char> &code) {
+  VkShaderModuleCreateInfo createInfo = {};
+  createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  createInfo.codeSize = code.size();
+  createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+
+  VkShaderModule shaderModule;
+  if (vkCreateShaderModule(_vkContext.GetLogicalDevice(), &createInfo, nullptr,
+                           &shaderModule) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create shader module!");
+  }
+
+  return shaderModule;
+}
+
+uint32_t SplatRasterPipeline::FindMemoryType(uint32_t typeFilter,
+                                             VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(_vkContext.GetPhysicalDevice(),
+                                      &memProperties);
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags &
+                                    properties) == properties) {
+      return i;
+    }
+  }
+
+  throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+void SplatRasterPipeline::CleanUp() {
+  VkDevice device = _vkContext.GetLogicalDevice();
+  if (device == VK_NULL_HANDLE || _wboitRenderPass == VK_NULL_HANDLE) {
+    return;
+  }
+
+  vkDestroyPipeline(device, _sortedPipeline, nullptr);
+  vkDestroyPipeline(device, _wboitPipeline, nullptr);
+  vkDestroyPipelineLayout(device, _pipelineLayout, nullptr);
+  vkDestroyDescriptorPool(device, _descriptorPool, nullptr);
+  vkDestroyDescriptorSetLayout(device, _descriptorSetLayout, nullptr);
+  vkDestroyFramebuffer(device, _sortedFrameBuffer, nullptr);
+  vkDestroyFramebuffer(device, _wboitFrameBuffer, nullptr);
+  vkDestroyRenderPass(device, _sortedRenderPass, nullptr);
+  vkDestroyRenderPass(device, _wboitRenderPass, nullptr);
+
+  for (Attachment *attachment : {&_accum, &_reveal}) {
+    vkDestroyImageView(device, attachment->view, nullptr);
+    vkDestroyImage(device, attachment->image, nullptr);
+    vkFreeMemory(device, attachment->memory, nullptr);
+    *attachment = Attachment();
+  }
+  _wboitRenderPass = VK_NULL_HANDLE;
+}
@@ -0,0 +1,23 @@
+#ifndef COUNTERS_GLSL
+#define COUNTERS_GLSL
+
+// Slots of the per-frame counters buffer. Keep in sync with ComputePipeline.h
+#define COUNTER_NUM_RENDERED 0
+#define COUNTER_SORT_INVERSIONS 1
+#define COUNTER_VISIBLE 2
+#define COUNTER_SPLIT_CHUNKS 3
+#define COUNTER_PREFIX_ARGS 4 // x, y, z of the prefix sum indirect dispatch
+#define COUNTER_OCCLUDED 7
+#define COUNTER_SPLIT_ARGS 8 // x, y, z of the render_chunk indirect dispatch
+#define COUNTER_SH_REDUCED 11 // evaluations below the full SH degree
+#define COUNTER_TILE_ARGS 12 // x, y, z of the rasterizer dispatch, one group per non-empty tile
+#define COUNTER_SH_LOD_ERROR 15 // summed 8-bit error of the reduced ones
+#define COUNTER_SH_EVALS 16 // SH evaluations, color cache misses included
+#define COUNTER_SH_FETCHES 17 // SH coefficients read by those evaluations
+#define COUNTER_CLUSTER_ARGS 18 // x, y, z of the preprocess dispatch over visible clusters
+#define COUNTER_BUDGET_BIN 21 // lowest importance bin kept by the splat budget
+#define COUNTER_BUDGET_DROPPED 22 // visible splats removed by the splat budget
+#define COUNTER_ROW_SPANS 23 // row table entries allocated by preprocess
+#define COUNTER_SPLATS_KEPT 24 // visible splats when COUNTER_VISIBLE holds every Gaussian
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef COVARIANCE_GLSL
+#define COVARIANCE_GLSL
+
+// 3D covariance Sigma = (S R)^T (S R) of a Gaussian, shared by preprocess and
+// the cov3d precomputation pass. Upper triangle: xx, xy, xz, yy, yz, zz.
+void covarianceFromScaleRotation(vec3 scale, vec4 rot, float scaleModifier,
+                                 out float cov3D_out[6]) {
+    // Scaling matrix
+    mat3 S = mat3(
+        scaleModifier * scale.x, 0.0, 0.0,
+        0.0, scaleModifier * scale.y, 0.0,
+        0.0, 0.0, scaleModifier * scale.z
+    );
+    
+    // Normalize quaternion and compute rotation matrix
+    vec4 q = normalize(rot);
+    float r = q.x, x = q.y, y = q.z, z = q.w;
+    
+    mat3 R = mat3(
+        1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y - r * z), 2.0 * (x * z + r * y),
+        2.0 * (x * y + r * z), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z - r * x),
+        2.0 * (x * z - r * y), 2.0 * (y * z + r * x), 1.0 - 2.0 * (x * x + y * y)
+    );
+    
+    mat3 M = S * R;
+    mat3 Sigma = transpose(M) * M;
+    
+    // Store symmetric matrix (upper triangle)
+    cov3D_out[0] = Sigma[0][0];
+    cov3D_out[1] = Sigma[0][1];
+    cov3D_out[2] = Sigma[0][2];
+    cov3D_out[3] = Sigma[1][1];
+    cov3D_out[4] = Sigma[1][2];
+    cov3D_out[5] = Sigma[2][2];
+}
+
+#endif
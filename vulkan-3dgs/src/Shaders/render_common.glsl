@@ -0,0 +1,137 @@
+#ifndef RENDER_COMMON_GLSL
+#define RENDER_COMMON_GLSL
+
+// Bindings, push constants and blending shared by the rasterizer kernels so
+// they can be swapped at runtime behind the same pipeline layout
+
+#extension GL_GOOGLE_include_directive : require
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+
+#include "splat_record.glsl"
+
+// Tile size, specialized at pipeline creation (TileSpecialization in
+// ComputePipeline.h). Ids 2 and 3 carry the render_quad workgroup size.
+layout (constant_id = 0) const uint TILE_WIDTH = 16;
+layout (constant_id = 1) const uint TILE_HEIGHT = 16;
+
+layout (std430, set = 0, binding = 0) readonly buffer Ranges {
+    uvec2 ranges[];
+};
+
+// Splat records in sorted order, written by pack_splats.comp
+layout (std430, set = 0, binding = 1) readonly buffer Records {
+    SplatRecord records[];
+};
+
+layout(set = 0, binding = 5) uniform writeonly image2D outputImage;
+
+// Non-empty tiles written by tile_boundaries.comp. The rasterizers run one
+// workgroup per entry
+layout (std430, set = 0, binding = 9) readonly buffer ActiveTiles {
+    uint activeTiles[];
+};
+
+// Heavy tile splitting, see tile_split.comp. tileSplit is (first chunk slot,
+// chunk count), zero for tiles rendered in one piece
+layout (std430, set = 0, binding = 6) readonly buffer TileSplit {
+    uvec2 tileSplit[];
+};
+
+layout (std430, set = 0, binding = 7) readonly buffer TileWork {
+    uvec4 tileWork[];
+};
+
+// Color and transmittance per pixel of every chunk
+layout (std430, set = 0, binding = 8) buffer Partials {
+    vec4 partials[];
+};
+
+// Saturation depth (saturationDepth) per pixel of every chunk, 0 outside the
+// image. render_merge.comp folds the first saturated chunk into tileDepth
+layout (std430, set = 0, binding = 16) buffer PartialDepths {
+    uint partialDepths[];
+};
+
+// Sorted keys, read for the depth of the splat that saturates a pixel
+layout (std430, set = 0, binding = 10) readonly buffer SortedKeys {
+    uint64_t keys[];
+};
+
+// Saturation depth per tile (float bits) for next frame's occlusion culling
+// in preprocess. Cleared to 0 every frame; +inf when a pixel of the tile
+// never saturated
+layout (std430, set = 0, binding = 11) buffer TileDepth {
+    uint tileDepth[];
+};
+
+layout( push_constant ) uniform Constants {
+    uint width;
+    uint height;
+    uint wireframe;
+    float gaussScale;
+};
+
+// Coverage mask bit of the subtile holding a pixel, local to its tile
+uint subtileBit(uvec2 localPixel) {
+    uvec2 subtile = localPixel * SUBTILES / uvec2(TILE_WIDTH, TILE_HEIGHT);
+    return 1u << (subtile.y * SUBTILES + subtile.x);
+}
+
+// False when the splat cannot reach the alpha cutoff anywhere in the subtile.
+// Wireframe draws a fixed pixel radius, so it ignores the mask.
+bool splatCovers(uint coverage, uint bit) {
+    return wireframe == 1 || (coverage & bit) != 0;
+}
+
+// Depth of the splat at sorted index index if it saturated the pixel, +inf
+// otherwise. Positive floats order like their bits, so atomicMax works on them
+#define UNSATURATED 0x7F800000u
+
+uint saturationDepth(bool saturated, uint index) {
+    return saturated ? uint(keys[index]) : UNSATURATED;
+}
+
+// Folds the saturation depth of each pixel into its tile, one atomic per
+// subgroup. Pixels outside the image pass 0 and do not count
+void recordSaturation(uint tile, uint depthBits) {
+    uint tileMax = subgroupMax(depthBits);
+    if (subgroupElect()) {
+        atomicMax(tileDepth[tile], tileMax);
+    }
+}
+
+// Blends one splat into the pixel. Returns false once the pixel is saturated
+// and the remaining splats of the tile can be skipped.
+bool blendSplat(inout vec3 C, inout float T, vec2 d, vec4 con_o, vec3 col) {
+    float power = -0.5f * (con_o.x * d.x * d.x + con_o.z * d.y * d.y) - con_o.y * d.x * d.y;
+    float alpha = min(0.99f, con_o.w * exp(power));
+
+    if (wireframe == 1) {
+        if (length(d) < gaussScale) {
+            float wireAlpha = 0.8 * alpha * (gaussScale / length(d));
+            C = C * (1.0 - wireAlpha) + col * wireAlpha;
+            T = max(0.0, T - wireAlpha);
+        }
+        return true;
+    }
+
+    if (power > 0.0f) {
+        return true;
+    }
+    // Skip if too transparent
+    if (alpha < 1.0f / 255.0f) {
+        return true;
+    }
+
+    float test_T = T * (1.0f - alpha);
+    if (test_T < 0.0001f) {
+        return false;
+    }
+
+    C += col * alpha * T;
+    T = test_T;
+    return true;
+}
+
+#endif
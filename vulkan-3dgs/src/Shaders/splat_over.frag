@@ -0,0 +1,34 @@
+#version 450
+
+// Depth-sorted hardware splatting. Instances arrive front to back, so the
+// blend state composites each fragment under what is already there:
+// dst += (1 - dst.a) * src with premultiplied src. The target ends up as
+// (C, 1 - T), the same form the tile rasterizers write.
+
+layout (push_constant) uniform Constants {
+    uint width;
+    uint height;
+    float depthScale;
+};
+
+layout (location = 0) flat in vec2 center;
+layout (location = 1) flat in vec4 conicO;
+layout (location = 2) flat in vec3 color;
+layout (location = 3) flat in float depth;
+
+layout (location = 0) out vec4 outColor;
+
+void main() {
+    // Same falloff and cutoffs as blendSplat in render_common.glsl
+    vec2 d = center - (gl_FragCoord.xy - 0.5);
+    float power = -0.5 * (conicO.x * d.x * d.x + conicO.z * d.y * d.y) - conicO.y * d.x * d.y;
+    if (power > 0.0) {
+        discard;
+    }
+    float alpha = min(0.99, conicO.w * exp(power));
+    if (alpha < 1.0 / 255.0) {
+        discard;
+    }
+
+    outColor = vec4(color * alpha, alpha);
+}
@@ -0,0 +1,57 @@
+#version 450
+
+// One screen-space quad per visible Gaussian, covering the radius computed by
+// preprocess. Instances map to Gaussians through an index list: the visible
+// list (compacted, or the full temporal order) for the sort-free path, the
+// depth-sorted order for the sorted quad path. Vertices 0..3 form a triangle
+// strip.
+
+layout (std430, set = 0, binding = 0) readonly buffer VisibleList {
+    uint visibleList[];
+};
+layout (std430, set = 0, binding = 1) readonly buffer Radii {
+    int radii[];
+};
+layout (std430, set = 0, binding = 2) readonly buffer Depths {
+    float depths[];
+};
+layout (std430, set = 0, binding = 3) readonly buffer PointsXY {
+    vec2 pointsXY[];
+};
+layout (std430, set = 0, binding = 4) readonly buffer ConicOpacity {
+    vec4 conicOpacity[];
+};
+layout (std430, set = 0, binding = 5) readonly buffer RGB {
+    vec4 rgb[];
+};
+
+layout (push_constant) uniform Constants {
+    uint width;
+    uint height;
+    float depthScale;
+};
+
+layout (location = 0) flat out vec2 center;
+layout (location = 1) flat out vec4 conicO;
+layout (location = 2) flat out vec3 color;
+layout (location = 3) flat out float depth;
+
+void main() {
+    uint idx = visibleList[gl_InstanceIndex];
+    int radius = radii[idx];
+    if (radius == 0) {
+        // Culled by preprocess, clipped away
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        return;
+    }
+
+    center = pointsXY[idx];
+    conicO = conicOpacity[idx];
+    color = rgb[idx].xyz;
+    depth = depths[idx];
+
+    // Pixel p of the compute path is sampled at framebuffer position p + 0.5
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1) * 2.0 - 1.0;
+    vec2 pixel = center + corner * (float(radius) + 1.0);
+    gl_Position = vec4((2.0 * pixel + 1.0) / vec2(width, height) - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,38 @@
+#ifndef SPLAT_RECORD_GLSL
+#define SPLAT_RECORD_GLSL
+
+// Per-instance splat data in sorted order, 24 bytes (SplatRecord in utils.h):
+//   xy           screen position, fp32
+//   conicOpacity conic.xyz + opacity, fp16 x4
+//   colorSpare   rgb fp16 x3, high 16 bits of .y hold the subtile coverage
+//                mask (bit y * 4 + x of the 4x4 subtiles of the key's tile)
+struct SplatRecord {
+    vec2 xy;
+    uvec2 conicOpacity;
+    uvec2 colorSpare;
+};
+
+#define SUBTILES 4
+
+SplatRecord packRecord(vec2 xy, vec4 conicOpacity, vec3 color, uint coverage) {
+    SplatRecord r;
+    r.xy = xy;
+    r.conicOpacity = uvec2(packHalf2x16(conicOpacity.xy), packHalf2x16(conicOpacity.zw));
+    r.colorSpare = uvec2(packHalf2x16(color.rg),
+                         (packHalf2x16(vec2(color.b, 0.0)) & 0xFFFFu) | (coverage << 16));
+    return r;
+}
+
+vec4 recordConicOpacity(SplatRecord r) {
+    return vec4(unpackHalf2x16(r.conicOpacity.x), unpackHalf2x16(r.conicOpacity.y));
+}
+
+vec3 recordColor(SplatRecord r) {
+    return vec3(unpackHalf2x16(r.colorSpare.x), unpackHalf2x16(r.colorSpare.y).x);
+}
+
+uint recordCoverage(SplatRecord r) {
+    return r.colorSpare.y >> 16;
+}
+
+#endif
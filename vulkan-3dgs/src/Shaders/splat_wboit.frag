@@ -0,0 +1,39 @@
+#version 450
+
+// Sort-free splatting with weighted blended order-independent transparency
+// (McGuire and Bavoil). Additive blending into accum, multiplicative into
+// reveal; wboit_resolve.comp normalizes. The depth weight is the exponential
+// falloff of the sort-free weighted-sum rendering work, so closer splats win
+// where several overlap.
+
+layout (push_constant) uniform Constants {
+    uint width;
+    uint height;
+    float depthScale;
+};
+
+layout (location = 0) flat in vec2 center;
+layout (location = 1) flat in vec4 conicO;
+layout (location = 2) flat in vec3 color;
+layout (location = 3) flat in float depth;
+
+layout (location = 0) out vec4 accum;  // sum(w * a * c), sum(w * a)
+layout (location = 1) out vec4 reveal; // prod(1 - a) through the blend state
+
+void main() {
+    // Same falloff and cutoffs as blendSplat in render_common.glsl
+    vec2 d = center - (gl_FragCoord.xy - 0.5);
+    float power = -0.5 * (conicO.x * d.x * d.x + conicO.z * d.y * d.y) - conicO.y * d.x * d.y;
+    if (power > 0.0) {
+        discard;
+    }
+    float alpha = min(0.99, conicO.w * exp(power));
+    if (alpha < 1.0 / 255.0) {
+        discard;
+    }
+
+    // Bounded to [1e-2, 1] so the fp16 sums neither overflow nor flush to zero
+    float w = clamp(exp(-depth / depthScale), 1e-2, 1.0);
+    accum = vec4(color * alpha, alpha) * w;
+    reveal = vec4(alpha);
+}
@@ -0,0 +1,64 @@
+#ifndef TILE_UTILS_GLSL
+#define TILE_UTILS_GLSL
+
+// Exact ellipse/tile intersection shared by preprocess (tile count) and idkeys
+// (key emission). Both passes must agree on the covered tiles, so everything
+// here is marked precise to keep the compiler from contracting it differently.
+
+// Mahalanobis threshold matching the 3-sigma extent used for the bounding box
+const float ELLIPSE_THRESHOLD = 9.0;
+
+// Tile rows from which preprocess stores a row table for idkeys. Shorter
+// splats are cheaper to walk than to search
+const uint ROW_TABLE_MIN_ROWS = 4;
+
+// Squared Mahalanobis distance at which opacity * exp(-0.5 * d^2) falls below
+// the 1/255 alpha cutoff of the render pass, capped at 3 sigma. Negative when
+// the splat can never reach the cutoff.
+float splatThreshold(float opacity, uint opacityAware) {
+    if (opacityAware == 0) {
+        return ELLIPSE_THRESHOLD;
+    }
+    precise float t = 2.0 * log(255.0 * opacity);
+    return min(ELLIPSE_THRESHOLD, t);
+}
+
+// Tile columns [span.x, span.y) of tile row tileY that intersect the ellipse
+// d^T * conic * d <= threshold centered at center. xRange is the bounding box
+// column range. Returns false when the row is not touched at all.
+bool ellipseRowSpan(vec2 center, vec3 conic, float threshold, int tileY,
+                    ivec2 tileSize, ivec2 xRange, out ivec2 span) {
+    span = ivec2(0);
+    precise float a = conic.x;
+    precise float b = conic.y;
+    precise float c = conic.z;
+    precise float det = a * c - b * b;
+    if (det <= 0.0 || a <= 0.0 || c <= 0.0) {
+        span = xRange;
+        return xRange.x < xRange.y;
+    }
+
+    // Vertical extent of the ellipse clipped to the pixel rows of this tile
+    precise float ymax = sqrt(threshold * a / det);
+    precise float lo = max(float(tileY * tileSize.y) - center.y, -ymax);
+    precise float hi = min(float(tileY * tileSize.y + tileSize.y - 1) - center.y, ymax);
+    if (lo > hi) {
+        return false;
+    }
+
+    // The left boundary is convex in dy with its minimum at the leftmost point
+    // of the ellipse, so clamping that point into the band gives the band's
+    // leftmost x. Same for the right side.
+    precise float xmax = sqrt(threshold * c / det);
+    precise float dyL = clamp(b * xmax / c, lo, hi);
+    precise float dyR = clamp(-b * xmax / c, lo, hi);
+    precise float xL = (-b * dyL - sqrt(max(0.0, a * threshold - det * dyL * dyL))) / a;
+    precise float xR = (-b * dyR + sqrt(max(0.0, a * threshold - det * dyR * dyR))) / a;
+
+    int first = max(xRange.x, int(floor((center.x + xL) / float(tileSize.x))));
+    int last = min(xRange.y, int(floor((center.x + xR) / float(tileSize.x))) + 1);
+    span = ivec2(first, last);
+    return first < last;
+}
+
+#endif
@@ -256,6 +256,7 @@ void ImguiUI::CreateUI(Camera &cam) {
     ImGui::Text("Resolution: %d x %d", g_renderSettings.width * resize,
                 g_renderSettings.height * resize);
     ImGui::Text("Number of Gaussians: %d", g_renderSettings.numGaussians);
+    ImGui::Text("Number of Visible Gaussians: %d", g_renderSettings.numVisible);
     ImGui::Text("Number of Rendered Splats: %d", g_renderSettings.numRendered);
 
     ImGui::Spacing();
@@ -299,10 +300,94 @@ void ImguiUI::CreateUI(Camera &cam) {
   ImGui::EndDisabled();
   ImGui::PopItemWidth();
   ImGui::Separator();
+  const char *tileSizes[] = {"8x8", "16x16", "32x16", "32x32"};
+  ImGui::Combo("Tile Size", &g_renderSettings.tileSize, tileSizes,
+               IM_ARRAYSIZE(tileSizes));
   ImGui::BeginDisabled(true);
-  ImGui::SliderInt("TileSize", &g_renderSettings.tileSize, 8, 256);
   ImGui::Button("Size Culling: ACTIVE");
   ImGui::EndDisabled();
+  ImGui::Checkbox("Exact Tile Intersection",
+                  &g_renderSettings.exactTileIntersection);
+  ImGui::Checkbox("Opacity-Aware Radius", &g_renderSettings.opacityAwareRadius);
+  ImGui::Checkbox("Subtile Coverage Masks", &g_renderSettings.subtileMasks);
+  ImGui::Checkbox("Occlusion Culling", &g_renderSettings.occlusionCulling);
+  ImGui::BeginDisabled(!g_renderSettings.occlusionCulling);
+  ImGui::SliderFloat("Max Move / Frame", &g_renderSettings.occlusionMaxMove,
+                     0.0f, 0.5f, "%.3f");
+  ImGui::Text("Occluded Gaussians: %d", g_renderSettings.numOccluded);
+  ImGui::EndDisabled();
+  ImGui::Checkbox("Cluster Culling", &g_renderSettings.clusterCulling);
+  ImGui::BeginDisabled(!g_renderSettings.clusterCulling);
+  ImGui::Text("Visible Clusters: %d / %d", g_renderSettings.numVisibleClusters,
+              g_renderSettings.numClusters);
+  ImGui::EndDisabled();
+  ImGui::Checkbox("Splat Budget", &g_renderSettings.splatBudget);
+  ImGui::BeginDisabled(!g_renderSettings.splatBudget);
+  ImGui::SliderInt("Budget", &g_renderSettings.splatBudgetCount, 10000,
+                   5000000);
+  ImGui::Checkbox("Budget Tile Instances", &g_renderSettings.budgetInstances);
+  ImGui::Text("Dropped Splats: %d", g_renderSettings.numBudgetDropped);
+  ImGui::EndDisabled();
+  ImGui::Separator();
+  // The controller owns the scale while dynamic resolution is on
+  ImGui::Checkbox("Dynamic Resolution", &g_renderSettings.dynamicResolution);
+  ImGui::BeginDisabled(g_renderSettings.dynamicResolution);
+  ImGui::SliderFloat("Render Scale", &g_renderSettings.renderScale, 0.25f,
+                     1.0f, "%.2f");
+  ImGui::EndDisabled();
+  ImGui::BeginDisabled(!g_renderSettings.dynamicResolution);
+  ImGui::SliderFloat("Target Frame (ms)", &g_renderSettings.targetFrameMs,
+                     2.0f, 50.0f, "%.1f");
+  ImGui::SliderFloat("Min Scale", &g_renderSettings.minRenderScale, 0.25f,
+                     1.0f, "%.2f");
+  ImGui::SliderFloat("Kp", &g_renderSettings.resolutionKp, 0.0f, 1.0f, "%.3f");
+  ImGui::SliderFloat("Ki", &g_renderSettings.resolutionKi, 0.0f, 0.5f, "%.3f");
+  ImGui::SliderFloat("Kd", &g_renderSettings.resolutionKd, 0.0f, 0.5f, "%.3f");
+  ImGui::EndDisabled();
+  ImGui::Text("Render: %d x %d, GPU %.2f ms", g_renderSettings.renderWidth,
+              g_renderSettings.renderHeight, g_renderSettings.gpuFrameMs);
+  ImGui::Separator();
+  ImGui::Checkbox("Idle Frame Skip", &g_renderSettings.idleSkip);
+  ImGui::BeginDisabled(!g_renderSettings.idleSkip);
+  ImGui::SliderInt("Idle FPS", &g_renderSettings.idleFps, 1, 60);
+  ImGui::Text("Idle: %s", g_renderSettings.idle ? "yes" : "no");
+  ImGui::EndDisabled();
+  ImGui::Separator();
+  const char *covPrecisions[] = {"Scale/Rotation", "Precomputed FP32",
+                                 "Precomputed FP16"};
+  ImGui::Combo("3D Covariance", &g_renderSettings.covPrecision, covPrecisions,
+               IM_ARRAYSIZE(covPrecisions));
+  // Preprocess GPU time of each storage, filled in as they are selected
+  for (int precision = 0; precision < NUM_COV_PRECISIONS; precision++) {
+    ImGui::Text("Preprocess (%s): %.3f ms", covPrecisions[precision],
+                g_renderSettings.preprocessTimeMs[precision]);
+  }
+  ImGui::Checkbox("Color Cache", &g_renderSettings.colorCache);
+  ImGui::BeginDisabled(!g_renderSettings.colorCache);
+  ImGui::SliderFloat("Reuse Angle", &g_renderSettings.colorCacheAngle, 0.05f,
+                     5.0f, "%.2f deg");
+  ImGui::EndDisabled();
+  ImGui::SliderInt("SH Degree", &g_renderSettings.shDegrees, 0,
+                   g_renderSettings.shDegreeMax);
+  ImGui::Checkbox("SH Level of Detail", &g_renderSettings.shLod);
+  ImGui::BeginDisabled(!g_renderSettings.shLod);
+  ImGui::SliderFloat("SH LOD Radius", &g_renderSettings.shLodRadius, 0.5f,
+                     32.0f, "%.1f px");
+  ImGui::SliderFloat("SH LOD Distance", &g_renderSettings.shLodDistance, 1.0f,
+                     500.0f, "%.1f");
+  if (ImGui::Button("Measure SH LOD Error")) {
+    g_renderSettings.shLodReportRequested = true;
+  }
+  if (g_renderSettings.shLodError >= 0.0f) {
+    ImGui::Text("Mean error: %.2f / 255", g_renderSettings.shLodError);
+  }
+  ImGui::EndDisabled();
+  ImGui::Text("SH Evaluated: %d (%d reduced, %d coeffs)",
+              g_renderSettings.numShEvals, g_renderSettings.numShReduced,
+              g_renderSettings.numShFetches);
+  ImGui::Text("SH Memory: %.1f MB (fixed degree %.1f MB)",
+              g_renderSettings.shBytes / (1024.0f * 1024.0f),
+              g_renderSettings.shBytesDense / (1024.0f * 1024.0f));
   ImGui::Separator();
   ImGui::Checkbox("Wireframe Mode", &g_renderSettings.showWireframe);
   ImGui::BeginDisabled(!g_renderSettings.showWireframe);
@@ -314,6 +399,76 @@ void ImguiUI::CreateUI(Camera &cam) {
   ImGui::Separator();
   ImGui::EndDisabled();
 
+  ImGui::Checkbox("Temporal Sort Reuse", &g_renderSettings.temporalSort);
+  ImGui::BeginDisabled(!g_renderSettings.temporalSort);
+  ImGui::SliderInt("Repair Passes", &g_renderSettings.sortRepairPasses, 0, 16);
+  ImGui::Text("Sort: %s (%u inversions)",
+              g_renderSettings.fullSort ? "full" : "incremental",
+              g_renderSettings.sortInversions);
+  ImGui::EndDisabled();
+
+  ImGui::Separator();
+  const char *rasterizers[] = {"Auto", "Per-Pixel", "Shared Memory",
+                               "2x2 Per Thread"};
+  ImGui::Combo("Rasterizer", &g_renderSettings.rasterizer, rasterizers,
+               IM_ARRAYSIZE(rasterizers));
+  ImGui::Text("Active: %s (%.3f ms)",
+              rasterizers[g_renderSettings.activeRasterizer],
+              g_renderSettings.rasterTimeMs);
+  ImGui::Checkbox("Tile IDs Per Key", &g_renderSettings.tileIdPerKey);
+  ImGui::SameLine();
+  ImGui::Text("%.3f ms", g_renderSettings.tileIdTimeMs);
+  ImGui::Checkbox("Split Heavy Tiles", &g_renderSettings.splitHeavyTiles);
+  ImGui::BeginDisabled(!g_renderSettings.splitHeavyTiles);
+  ImGui::SliderInt("Chunk Size", &g_renderSettings.tileChunkSize, 256, 16384);
+  ImGui::EndDisabled();
+  ImGui::Checkbox("Packed Splat Records", &g_renderSettings.packedSplats);
+
+  ImGui::Separator();
+  const char *renderModes[] = {"Sorted", "Sort-Free (WBOIT)",
+                               "Sorted Quads (HW)"};
+  ImGui::Combo("Render Path", &g_renderSettings.renderMode, renderModes,
+               IM_ARRAYSIZE(renderModes));
+  ImGui::BeginDisabled(g_renderSettings.renderMode !=
+                       int(RenderMode::SortFree));
+  ImGui::SliderFloat("WBOIT Depth Falloff", &g_renderSettings.wboitDepthScale,
+                     0.5f, 50.0f, "%.1f");
+  ImGui::EndDisabled();
+  // PSNR of each path against the sorted compute path
+  for (int mode = 0; mode < NUM_RENDER_MODES; mode++) {
+    float psnr = g_renderSettings.comparePsnr[mode];
+    if (mode == int(RenderMode::Sorted) || psnr < 0.0f) {
+      ImGui::Text("%s: %.3f ms", renderModes[mode],
+                  g_renderSettings.pathTimeMs[mode]);
+    } else {
+      ImGui::Text("%s: %.3f ms, %.2f dB", renderModes[mode],
+                  g_renderSettings.pathTimeMs[mode], psnr);
+    }
+  }
+  if (ImGui::Button("Compare Paths")) {
+    g_renderSettings.compareRequested = true;
+  }
+
+  ImGui::Separator();
+  // Values 0, 1, ... of the selected setting on the sorted path, see
+  // RenderSettings::settingCheck
+  const char *settingChecks[] = {"Exact Tile Intersection",
+                                 "Opacity Aware Radius", "Tile ID Threads",
+                                 "Packed Splats", "Covariance Storage"};
+  static int settingCheck = 0;
+  ImGui::Combo("Setting Check", &settingCheck, settingChecks,
+               IM_ARRAYSIZE(settingChecks));
+  ImGui::BeginDisabled(g_renderSettings.settingCheckRunning);
+  if (ImGui::Button("Run Check")) {
+    g_renderSettings.settingCheck = settingCheck + 1;
+  }
+  ImGui::EndDisabled();
+  if (g_renderSettings.settingCheckRunning) {
+    ImGui::SameLine();
+    ImGui::Text("Running, hold the camera still");
+  }
+  ImGui::TextUnformatted(g_renderSettings.settingCheckReport.c_str());
+
   ImGui::Separator();
   static float rotX = 0.0f;
   static float rotY = 0.0f;
@@ -11,8 +11,25 @@ glslangValidator.exe -V --target-env spirv1.3 ../Shaders/prefixsum.comp -o ../Sh
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/radix_sort/radixsort.comp -o ../Shaders/sort.spv
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/radix_sort/histogram.comp -o ../Shaders/histogram.spv
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/idkeys.comp -o ../Shaders/idkeys.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/idkeys_gaussian.comp -o ../Shaders/idkeys_gaussian.spv
 glslangValidator.exe -V --target-env spirv1.3 ../Shaders/tile_boundaries.comp -o ../Shaders/boundaries.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/depthkeys.comp -o ../Shaders/depthkeys.spv
+glslangValidator.exe -V --target-env spirv1.3 ../Shaders/sort_repair.comp -o ../Shaders/repair.spv
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/render_shared_mem.comp -o ../Shaders/render_shared.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/render_quad.comp -o ../Shaders/render_quad.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/pack_splats.comp -o ../Shaders/pack_splats.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/tile_split.comp -o ../Shaders/tile_split.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/render_chunk.comp -o ../Shaders/render_chunk.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/render_merge.comp -o ../Shaders/render_merge.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/render_gather.comp -o ../Shaders/render_gather.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/wboit_resolve.comp -o ../Shaders/wboit_resolve.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/splat_quad.vert -o ../Shaders/splat_quad_vert.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/splat_wboit.frag -o ../Shaders/splat_wboit_frag.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/splat_over.frag -o ../Shaders/splat_over_frag.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/cov3d.comp -o ../Shaders/cov3d.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/cluster_cull.comp -o ../Shaders/cluster_cull.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/splat_budget.comp -o ../Shaders/splat_budget.spv
+glslangValidator.exe -V --target-env spirv1.5 ../Shaders/upsample.comp -o ../Shaders/upsample.spv
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/render.comp -o ../Shaders/render.spv
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/frag_axis.frag -o ../Shaders/axis_frag.spv
 glslangValidator.exe -V --target-env spirv1.5 ../Shaders/vertex_axis.vert -o ../Shaders/axis_vert.spv
@@ -8,8 +8,24 @@ glslangValidator -V --target-env spirv1.3 ../Shaders/preprocess.comp -o ../Shade
 glslangValidator -V --target-env spirv1.3 ../Shaders/debugGaussians.comp -o ../Shaders/nearest.spv
 glslangValidator -V --target-env spirv1.3 ../Shaders/prefixsum.comp -o ../Shaders/sum.spv
 glslangValidator -V --target-env spirv1.5 ../Shaders/idkeys.comp -o ../Shaders/idkeys.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/idkeys_gaussian.comp -o ../Shaders/idkeys_gaussian.spv
 glslangValidator -V --target-env spirv1.3 ../Shaders/tile_boundaries.comp -o ../Shaders/boundaries.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/depthkeys.comp -o ../Shaders/depthkeys.spv
+glslangValidator -V --target-env spirv1.3 ../Shaders/sort_repair.comp -o ../Shaders/repair.spv
 glslangValidator -V --target-env spirv1.5 ../Shaders/render_shared_mem.comp -o ../Shaders/render_shared.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/render_quad.comp -o ../Shaders/render_quad.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/pack_splats.comp -o ../Shaders/pack_splats.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/tile_split.comp -o ../Shaders/tile_split.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/render_chunk.comp -o ../Shaders/render_chunk.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/render_merge.comp -o ../Shaders/render_merge.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/render_gather.comp -o ../Shaders/render_gather.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/wboit_resolve.comp -o ../Shaders/wboit_resolve.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/splat_quad.vert -o ../Shaders/splat_quad_vert.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/splat_wboit.frag -o ../Shaders/splat_wboit_frag.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/splat_over.frag -o ../Shaders/splat_over_frag.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/cov3d.comp -o ../Shaders/cov3d.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/cluster_cull.comp -o ../Shaders/cluster_cull.spv
+glslangValidator -V --target-env spirv1.5 ../Shaders/splat_budget.comp -o ../Shaders/splat_budget.spv
 glslangValidator -V --target-env spirv1.5 ../Shaders/upsample.comp -o ../Shaders/upsample.spv
 glslangValidator -V --target-env spirv1.5 ../Shaders/vertex_axis.vert -o ../Shaders/axis_vert.spv
 glslangValidator -V --target-env spirv1.5 ../Shaders/frag_axis.frag -o ../Shaders/axis_frag.spv